@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+// shared helpers for the benchmarks under bench/ - each one is a standalone program (make bench builds and runs them all).
+namespace bench {
+
+// fastest of runs calls of f, in nanoseconds. the first call warms up caches and pages and is not counted.
+template <typename F>
+double best_ns(F&& f, int runs = 5)
+{
+	f();
+	auto best{std::numeric_limits<double>::max()};
+	for (int r{0}; r < runs; ++r) {
+		const auto start{std::chrono::steady_clock::now()};
+		f();
+		const auto stop{std::chrono::steady_clock::now()};
+		best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+	}
+	return best;
+}
+
+// keeps value (and whatever computed it) from being optimized away.
+template <typename T>
+void keep(const T& value)
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+// 64-bit linear congruential generator - cheap, deterministic pseudo random inputs.
+struct lcg {
+	std::uint64_t state{1};
+
+	constexpr std::uint64_t operator()()
+	{
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		return state >> 16;
+	}
+};
+
+}//bench
@@ -0,0 +1,52 @@
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include "metarray.hpp"
+#include "metalgo.hpp"
+#include "metacache.hpp"
+#include "bench.hpp"
+
+// cached_array against recomputing the aggregates: random single-item writes, then one query of the sum, min, max and the row sums.
+// ns per query (including its writes), for a few write/read mixes.
+int main()
+{
+	using namespace metarray;
+	using table_t = std::array<std::array<double, 1024>, 1024>;
+	constexpr std::size_t queries{200};
+
+	auto a{std::make_unique<table_t>()};
+	for (std::size_t offset{0}; offset < total_items_v<table_t>; ++offset) {
+		at_offset(*a, offset) = static_cast<double>(offset % 97);
+	}
+
+	std::printf("%-14s%14s%14s\n", "writes/query", "recompute", "cached");
+	for (const std::size_t writes : {1u, 10u, 100u, 1000u}) {
+		const auto recompute{bench::best_ns([&] {
+			bench::lcg rng{};
+			for (std::size_t q{0}; q < queries; ++q) {
+				for (std::size_t w{0}; w < writes; ++w) {
+					const auto r{rng()};
+					at_offset(*a, r % total_items_v<table_t>) = static_cast<double>(r >> 40);
+				}
+				const auto [total, lowest, highest]{reduce_many(*a, sum_reducer{}, min_reducer{}, max_reducer{})};
+				const auto rows{sum<1>(*a)};
+				bench::keep(total + lowest + highest + rows[3]);
+			}
+		}, 3)};
+
+		cached_array<table_t, cached::sum | cached::min | cached::max | cached::axis_sums> c{*a};
+		const auto cached{bench::best_ns([&] {
+			bench::lcg rng{};
+			for (std::size_t q{0}; q < queries; ++q) {
+				for (std::size_t w{0}; w < writes; ++w) {
+					const auto r{rng()};
+					c.set(r % total_items_v<table_t>, static_cast<double>(r >> 40));
+				}
+				bench::keep(c.sum() + c.min() + c.max() + c.axis_sums<0>()[3]);
+			}
+		}, 3)};
+
+		std::printf("%-14zu%14.0f%14.0f\n", writes, recompute / queries, cached / queries);
+	}
+}
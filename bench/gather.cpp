@@ -0,0 +1,81 @@
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "metarray.hpp"
+#include "metalgo.hpp"
+#include "bench.hpp"
+
+// gather and scatter throughput for random batches, by offset and by indexer, against a plain loop over the flat data. arrays from
+// L2 size up to well past the last level cache. ns per item.
+namespace {
+
+using namespace metarray;
+
+constexpr std::size_t batch{std::size_t{1} << 22};
+
+template <std::size_t Rows>
+void run()
+{
+	using table_t = std::array<std::array<float, 1024>, Rows>;
+	auto a{std::make_unique<table_t>()};
+	for (std::size_t offset{0}; offset < total_items_v<table_t>; ++offset) {
+		at_offset(*a, offset) = static_cast<float>(offset);
+	}
+
+	std::vector<std::size_t> offsets(batch);
+	std::vector<runtime_indexer_of_t<table_t>> idxs(batch);
+	bench::lcg rng{};
+	for (std::size_t i{0}; i < batch; ++i) {
+		offsets[i] = rng() % total_items_v<table_t>;
+		idxs[i] = runtime_indexer_from_offset(*a, offsets[i]);
+	}
+	std::vector<float> values(batch);
+
+	const auto loop_gather{bench::best_ns([&] {
+		const float* data{flat_data(*a)};
+		for (std::size_t i{0}; i < batch; ++i) {
+			values[i] = data[offsets[i]];
+		}
+		bench::keep(values);
+	})};
+	const auto offset_gather{bench::best_ns([&] {
+		gather(*a, offsets, values);
+		bench::keep(values);
+	})};
+	const auto indexer_gather{bench::best_ns([&] {
+		gather(*a, idxs, values);
+		bench::keep(values);
+	})};
+	const auto loop_scatter{bench::best_ns([&] {
+		float* data{flat_data(*a)};
+		for (std::size_t i{0}; i < batch; ++i) {
+			data[offsets[i]] = values[i];
+		}
+		bench::keep(*a);
+	})};
+	const auto offset_scatter{bench::best_ns([&] {
+		scatter(*a, offsets, values);
+		bench::keep(*a);
+	})};
+	const auto indexer_scatter{bench::best_ns([&] {
+		scatter(*a, idxs, values);
+		bench::keep(*a);
+	})};
+
+	constexpr auto items{static_cast<double>(batch)};
+	std::printf("%9zu%10.2f%10.2f%10.2f%10.2f%10.2f%10.2f\n", sizeof(table_t) / 1024, loop_gather / items, offset_gather / items,
+		indexer_gather / items, loop_scatter / items, offset_scatter / items, indexer_scatter / items);
+}
+
+}
+
+int main()
+{
+	std::printf("%9s%30s%30s\n", "", "gather", "scatter");
+	std::printf("%9s%10s%10s%10s%10s%10s%10s\n", "KiB", "loop", "offsets", "indexers", "loop", "offsets", "indexers");
+	run<64>();
+	run<1024>();
+	run<65536>();
+}
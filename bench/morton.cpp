@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "metarray.hpp"
+#include "metalgo.hpp"
+#include "metamorton.hpp"
+#include "bench.hpp"
+
+// neighborhood queries on a 256^3 float array, row-major against morton_array: the sum of the (2r+1)^3 cube around random centers.
+// besides the time, the distinct 64-byte cache lines and 4 KiB pages each query touches - what the z-order storage is meant to cut.
+namespace {
+
+using namespace metarray;
+
+using row_major_t = std::array<std::array<std::array<float, 256>, 256>, 256>;
+using morton_t = morton_array<float, extents_of_t<row_major_t>>;
+using index_t = std::array<std::size_t, 3>;
+
+template <typename A>
+float neighborhood_sums(const A& a, const std::vector<index_t>& centers, std::size_t radius)
+{
+	float total{0.0f};
+	for (const auto& c : centers) {
+		for (auto i{c[0] - radius}; i <= c[0] + radius; ++i) {
+			for (auto j{c[1] - radius}; j <= c[1] + radius; ++j) {
+				for (auto k{c[2] - radius}; k <= c[2] + radius; ++k) {
+					total += get(a, runtime_indexer_of_t<A>{{i, j, k}});
+				}
+			}
+		}
+	}
+	return total;
+}
+
+// average number of distinct blocks of block_bytes that a query reads, with storage_index mapping an index to where the item is stored.
+template <typename F>
+double blocks_per_query(const std::vector<index_t>& centers, std::size_t radius, std::size_t block_bytes, F storage_index)
+{
+	std::vector<std::size_t> blocks{};
+	std::size_t total{0};
+	for (const auto& c : centers) {
+		blocks.clear();
+		for (auto i{c[0] - radius}; i <= c[0] + radius; ++i) {
+			for (auto j{c[1] - radius}; j <= c[1] + radius; ++j) {
+				for (auto k{c[2] - radius}; k <= c[2] + radius; ++k) {
+					blocks.push_back(storage_index({i, j, k}) * sizeof(float) / block_bytes);
+				}
+			}
+		}
+		std::ranges::sort(blocks);
+		total += static_cast<std::size_t>(std::ranges::distance(blocks.begin(), std::ranges::unique(blocks).begin()));
+	}
+	return static_cast<double>(total) / static_cast<double>(centers.size());
+}
+
+}
+
+int main()
+{
+	auto row_major{std::make_unique<row_major_t>()};
+	auto morton{std::make_unique<morton_t>()};
+	for (std::size_t offset{0}; offset < total_items_v<row_major_t>; ++offset) {
+		at_offset(*row_major, offset) = static_cast<float>(offset % 13);
+		morton->at_offset(offset) = static_cast<float>(offset % 13);
+	}
+
+	// centers far enough from the edges for every radius
+	std::vector<index_t> centers(200000);
+	bench::lcg rng{};
+	for (auto& c : centers) {
+		for (auto& x : c) {
+			x = 4 + rng() % 248;
+		}
+	}
+	const std::vector<index_t> sampled(centers.begin(), centers.begin() + 10000);
+
+	const auto row_major_index{[](const index_t& index) { return runtime_offset_from_indexer(runtime_indexer_of_t<row_major_t>{index}); }};
+	const auto morton_index{[](const index_t& index) { return morton_t::layout::encode(index); }};
+
+	std::printf("%-8s%-10s%10s%11s%11s%14s%11s%14s\n", "radius", "cube", "row ns", "morton ns", "row lines", "morton lines", "row pages",
+		"morton pages");
+	for (const std::size_t radius : {1u, 2u, 3u}) {
+		const auto row_ns{bench::best_ns([&] { bench::keep(neighborhood_sums(*row_major, centers, radius)); }, 3)};
+		const auto morton_ns{bench::best_ns([&] { bench::keep(neighborhood_sums(*morton, centers, radius)); }, 3)};
+		const auto side{2 * radius + 1};
+		std::printf("%-8zu%zux%zux%-6zu%10.1f%11.1f%11.1f%14.1f%11.1f%14.1f\n", radius, side, side, side,
+			row_ns / static_cast<double>(centers.size()), morton_ns / static_cast<double>(centers.size()),
+			blocks_per_query(sampled, radius, 64, row_major_index), blocks_per_query(sampled, radius, 64, morton_index),
+			blocks_per_query(sampled, radius, 4096, row_major_index), blocks_per_query(sampled, radius, 4096, morton_index));
+	}
+}
@@ -0,0 +1,112 @@
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <span>
+#include <utility>
+#include <vector>
+#include "metarray.hpp"
+#include "bench.hpp"
+
+// runtime offset -> indexer conversion: plain division by the extents (read at runtime, so the compiler can't swap in its own
+// reciprocals), division by constant extents, runtime_indexer_from_offset's multiply-shift reciprocals, and the batched
+// runtime_indexers_from_offsets. ns per offset.
+namespace {
+
+using namespace metarray;
+
+constexpr std::size_t offset_count{8192};
+constexpr int rounds{64};
+
+template <std::size_t...Es>
+void run(const std::index_sequence<Es...>&)
+{
+	using idx_t = runtime_indexer<std::index_sequence<Es...>>;
+	constexpr std::size_t total{(Es * ...)};
+	constexpr auto& divisors{offset_divisors_v<std::index_sequence<Es...>>};
+
+	std::vector<std::size_t> offsets(offset_count);
+	bench::lcg rng{};
+	for (auto& offset : offsets) {
+		offset = rng() % total;
+	}
+	std::vector<idx_t> result(offset_count);
+
+	// the extents go through a volatile, so these are real divisions
+	volatile std::size_t runtime_extents[sizeof...(Es)]{Es...};
+	std::array<std::size_t, sizeof...(Es)> divide_by{};
+	for (std::size_t r{0}; r < divide_by.size(); ++r) {
+		divide_by[r] = runtime_extents[r];
+	}
+
+	const auto division{bench::best_ns([&] {
+		for (int round{0}; round < rounds; ++round) {
+			for (std::size_t i{0}; i < offsets.size(); ++i) {
+				auto offset{offsets[i]};
+				for (std::size_t r{divide_by.size()}; r-- > 0;) {
+					result[i].index[r] = offset % divide_by[r];
+					offset /= divide_by[r];
+				}
+			}
+			bench::keep(result);
+		}
+	})};
+
+	const auto constant_division{bench::best_ns([&] {
+		constexpr std::array<std::size_t, sizeof...(Es)> constant_extents{Es...};
+		for (int round{0}; round < rounds; ++round) {
+			for (std::size_t i{0}; i < offsets.size(); ++i) {
+				auto offset{offsets[i]};
+				[&]<std::size_t...Rs>(const std::index_sequence<Rs...>&) {
+					((result[i].index[sizeof...(Es) - 1 - Rs] = offset % constant_extents[sizeof...(Es) - 1 - Rs],
+						offset /= constant_extents[sizeof...(Es) - 1 - Rs]), ...);
+				}(std::make_index_sequence<sizeof...(Es)>{});
+			}
+			bench::keep(result);
+		}
+	})};
+
+	const auto magic{bench::best_ns([&] {
+		for (int round{0}; round < rounds; ++round) {
+			for (std::size_t i{0}; i < offsets.size(); ++i) {
+				result[i] = runtime_indexer_from_offset<std::index_sequence<Es...>>(offsets[i]);
+			}
+			bench::keep(result);
+		}
+	})};
+
+	const auto batched{bench::best_ns([&] {
+		for (int round{0}; round < rounds; ++round) {
+			runtime_indexers_from_offsets<std::index_sequence<Es...>>(offsets, result);
+			bench::keep(result);
+		}
+	})};
+
+	constexpr auto shape{[] {
+		std::array<char, 32> text{};
+		std::size_t length{0};
+		for (const auto e : {Es...}) {
+			length += static_cast<std::size_t>(std::snprintf(text.data() + length, text.size() - length, length == 0 ? "%zu" : "x%zu", e));
+		}
+		return text;
+	}};
+	constexpr auto per_offset{static_cast<double>(offset_count) * rounds};
+	std::printf("%-16s%10.2f%12.2f%8.2f%9.2f", shape().data(), division / per_offset, constant_division / per_offset, magic / per_offset,
+		batched / per_offset);
+	for (std::size_t r{0}; r < divisors.size(); ++r) {
+		if (divisors[r].multiplier == 0) {
+			std::printf("  hardware division on axis %zu", r);
+		}
+	}
+	std::printf("\n");
+}
+
+}
+
+int main()
+{
+	std::printf("%-16s%10s%12s%8s%9s\n", "extents", "division", "constant /", "magic", "batched");
+	run(std::index_sequence<97, 61, 31>{});
+	run(std::index_sequence<1000, 1000>{});
+	run(std::index_sequence<7, 11, 13, 17, 19>{});
+	run(std::index_sequence<3000, 3000, 3000>{});
+}
@@ -0,0 +1,68 @@
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+#include "metarray.hpp"
+#include "metasparse.hpp"
+#include "bench.hpp"
+
+// compress() on a 256x256 int table with ~1% of the items differing from the fill: bytes of the dense and the sparse table, and random
+// lookups through get on the dense table against at_offset on the sparse one. ns per lookup.
+namespace {
+
+using namespace metarray;
+
+constexpr std::size_t lookup_count{std::size_t{1} << 20};
+constexpr int rounds{20};
+
+constexpr auto dense{[] {
+	std::array<std::array<int, 256>, 256> a{};
+	bench::lcg rng{};
+	for (std::size_t i{0}; i < total_items_v<decltype(a)> / 100; ++i) {
+		const auto offset{rng() % total_items_v<decltype(a)>};
+		a[offset / 256][offset % 256] = static_cast<int>(rng() % 1000) + 1;
+	}
+	return a;
+}()};
+
+struct static_dense { constexpr static auto& value{dense}; };
+
+constexpr auto sparse{compress<static_dense>()};
+
+}
+
+int main()
+{
+	std::vector<std::size_t> offsets(lookup_count);
+	std::vector<runtime_indexer_of_t<decltype(dense)>> idxs(lookup_count);
+	bench::lcg rng{};
+	for (std::size_t i{0}; i < lookup_count; ++i) {
+		offsets[i] = rng() % total_items_v<decltype(dense)>;
+		idxs[i] = runtime_indexer_from_offset(dense, offsets[i]);
+	}
+
+	const auto dense_get{bench::best_ns([&] {
+		long long total{0};
+		for (int round{0}; round < rounds; ++round) {
+			for (const auto& idx : idxs) {
+				total += get(dense, idx);
+			}
+		}
+		bench::keep(total);
+	})};
+	const auto sparse_at_offset{bench::best_ns([&] {
+		long long total{0};
+		for (int round{0}; round < rounds; ++round) {
+			for (const auto offset : offsets) {
+				total += sparse.at_offset(offset);
+			}
+		}
+		bench::keep(total);
+	})};
+
+	constexpr auto lookups{static_cast<double>(lookup_count) * rounds};
+	std::printf("%12s%12s%12s\n", "", "bytes", "ns/lookup");
+	std::printf("%12s%12zu%12.2f\n", "dense", sizeof(dense), dense_get / lookups);
+	std::printf("%12s%12zu%12.2f\n", "sparse", sizeof(sparse), sparse_at_offset / lookups);
+	std::printf("%zu of %zu items stored\n", sparse.values.size(), total_items_v<decltype(dense)>);
+}
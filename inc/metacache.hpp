@@ -0,0 +1,222 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "metarray.hpp"
+#include "metalgo.hpp"
+
+namespace metarray {
+
+// --- cached reductions -------------------------------------------------------------------------------------------------------------------
+// aggregates a cached_array keeps up to date. combine with |.
+enum class cached : unsigned {
+	sum = 1u << 0,
+	count = 1u << 1,// items matching the predicate
+	axis_sums = 1u << 2,// for every axis and index along it, the sum of the items at that index (e.g. row and column sums)
+	min = 1u << 3,
+	max = 1u << 4,
+	all = (1u << 5) - 1,
+};
+
+constexpr cached operator|(cached lhs, cached rhs)
+{
+	return static_cast<cached>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+}
+
+constexpr bool has_cached(cached flags, cached aggregate)
+{
+	return (static_cast<unsigned>(flags) & static_cast<unsigned>(aggregate)) != 0;
+}
+
+struct is_nonzero {
+	template <typename T>
+	constexpr bool operator()(const T& item) const
+	{
+		return item != T{};
+	}
+};
+
+// read-only custom array over another array, with writes going through set(). the aggregates in Flags are computed once up front and
+// then patched on every write - O(1) for sum and count, O(rank) for axis sums. min and max are kept while writes only improve them; a
+// write over the current min (max) with something larger (smaller) drops it, and the next query rescans the array. floating point sums
+// pick up rounding from every patch - refresh() recomputes everything.
+template <array A, cached Flags = cached::sum, typename Pred = is_nonzero>
+class cached_array {
+public:
+	using extents_type = extents_of_t<A>;
+	using value_type = remove_all_extents_t<A>;
+	using sum_type = decltype(value_type{} + value_type{});
+
+	explicit constexpr cached_array(A& a, Pred pred = {})
+		: array_{a}
+		, pred_{pred}
+		, sum_{}
+		, count_{}
+		, axis_sums_{}
+		, min_{}
+		, max_{}
+		, min_offset_{}
+		, max_offset_{}
+		, min_valid_{}
+		, max_valid_{}
+	{
+		refresh();
+	}
+
+	constexpr const value_type& at_offset(std::size_t offset) const
+	{
+		return metarray::at_offset(std::as_const(array_), offset);
+	}
+
+	constexpr void set(std::size_t offset, const value_type& item)
+	{
+		auto& stored{metarray::at_offset(array_, offset)};
+		const auto old{stored};
+		stored = item;
+
+		if constexpr (has_cached(Flags, cached::sum) || has_cached(Flags, cached::axis_sums)) {
+			const auto delta{static_cast<sum_type>(static_cast<sum_type>(item) - static_cast<sum_type>(old))};
+			if constexpr (has_cached(Flags, cached::sum)) {
+				sum_ += delta;
+			}
+			if constexpr (has_cached(Flags, cached::axis_sums)) {
+				const auto idx{runtime_indexer_from_offset<extents_type>(offset)};
+				for (std::size_t r{0}; r < rank_v<A>; ++r) {
+					axis_sums_[axis_first[r] + idx.index[r]] += delta;
+				}
+			}
+		}
+		if constexpr (has_cached(Flags, cached::count)) {
+			count_ = count_ + (pred_(item) ? 1u : 0u) - (pred_(old) ? 1u : 0u);
+		}
+		if constexpr (has_cached(Flags, cached::min)) {
+			if (min_valid_ && item < min_) {
+				min_ = item;
+				min_offset_ = offset;
+			}
+			else if (offset == min_offset_ && min_ < item) {
+				min_valid_ = false;
+			}
+		}
+		if constexpr (has_cached(Flags, cached::max)) {
+			if (max_valid_ && max_ < item) {
+				max_ = item;
+				max_offset_ = offset;
+			}
+			else if (offset == max_offset_ && item < max_) {
+				max_valid_ = false;
+			}
+		}
+	}
+
+	constexpr void set(const runtime_indexer<extents_type>& idx, const value_type& item)
+	{
+		set(runtime_offset_from_indexer(idx), item);
+	}
+
+	template <valid_indexer Idx>
+	requires valid_indexer_of<A, Idx>
+	constexpr void set(const value_type& item)
+	{
+		set(offset_from_indexer_v<Idx>, item);
+	}
+
+	constexpr sum_type sum() const
+	requires (has_cached(Flags, cached::sum))
+	{
+		return sum_;
+	}
+
+	constexpr std::size_t count() const
+	requires (has_cached(Flags, cached::count))
+	{
+		return count_;
+	}
+
+	// sums of the items at every index along Axis.
+	template <std::size_t Axis>
+	requires (has_cached(Flags, cached::axis_sums) && Axis < rank_v<A>)
+	constexpr std::span<const sum_type, extent_v<A, Axis>> axis_sums() const
+	{
+		return std::span<const sum_type, extent_v<A, Axis>>{axis_sums_.data() + axis_first[Axis], extent_v<A, Axis>};
+	}
+
+	constexpr value_type min()
+	requires (has_cached(Flags, cached::min))
+	{
+		if (not min_valid_) {
+			min_offset_ = runtime_offset_from_indexer(argmin(array_));
+			min_ = metarray::at_offset(array_, min_offset_);
+			min_valid_ = true;
+		}
+		return min_;
+	}
+
+	constexpr value_type max()
+	requires (has_cached(Flags, cached::max))
+	{
+		if (not max_valid_) {
+			max_offset_ = runtime_offset_from_indexer(argmax(array_));
+			max_ = metarray::at_offset(array_, max_offset_);
+			max_valid_ = true;
+		}
+		return max_;
+	}
+
+	// recomputes all aggregates from the array - after writes that bypassed set(), or to drop accumulated rounding.
+	constexpr void refresh()
+	{
+		if constexpr (has_cached(Flags, cached::sum) || has_cached(Flags, cached::count)) {
+			std::tie(sum_, count_) = reduce_many(std::as_const(array_), sum_reducer{}, count_if_reducer{pred_});
+		}
+		if constexpr (has_cached(Flags, cached::axis_sums)) {
+			axis_sums_.fill(sum_type{});
+			for_each_run(std::as_const(array_), [this](auto run, std::size_t offset) {
+				for (std::size_t i{0}; i < run.size(); ++i) {
+					const auto idx{runtime_indexer_from_offset<extents_type>(offset + i)};
+					for (std::size_t r{0}; r < rank_v<A>; ++r) {
+						axis_sums_[axis_first[r] + idx.index[r]] += run[i];
+					}
+				}
+			});
+		}
+		min_valid_ = false;
+		max_valid_ = false;
+	}
+
+private:
+	// where the sums of each axis start in axis_sums_
+	inline static constexpr auto axis_first{[]<std::size_t...Is>(const std::index_sequence<Is...>&) {
+		std::array<std::size_t, rank_v<A> + 1> first{0, extent_v<A, Is>...};
+		for (std::size_t r{1}; r < first.size(); ++r) {
+			first[r] += first[r - 1];
+		}
+		return first;
+	}(std::make_index_sequence<rank_v<A>>{})};
+
+	A& array_;
+	Pred pred_;
+	sum_type sum_;
+	std::size_t count_;
+	std::array<sum_type, has_cached(Flags, cached::axis_sums) ? axis_first.back() : 0> axis_sums_;
+	value_type min_;
+	value_type max_;
+	std::size_t min_offset_;
+	std::size_t max_offset_;
+	bool min_valid_;
+	bool max_valid_;
+};
+
+template <array A, cached Flags, typename Pred>
+constexpr auto sum(const cached_array<A, Flags, Pred>& a)
+requires (has_cached(Flags, cached::sum))
+{
+	const instrument_scope<cached_array<A, Flags, Pred>> instrument{"sum"};
+	return a.sum();
+}
+
+}//metarray
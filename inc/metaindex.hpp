@@ -0,0 +1,232 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include "metarray.hpp"
+#include "metalgo.hpp"
+
+namespace metarray {
+
+// --- value index -------------------------------------------------------------------------------------------------------------------------
+template <typename T>
+concept hashable_item = std::integral<T> || std::floating_point<T> || std::is_enum_v<T>;
+
+constexpr std::uint64_t mix_hash(std::uint64_t h)
+{
+	// splitmix64 finalizer
+	h ^= h >> 30;
+	h *= 0xbf58476d1ce4e5b9ull;
+	h ^= h >> 27;
+	h *= 0x94d049bb133111ebull;
+	return h ^ (h >> 31);
+}
+
+template <hashable_item T>
+constexpr std::uint64_t item_hash(const T& item)
+{
+	if constexpr (std::floating_point<T>) {
+		// 0.0 == -0.0, so they have to hash the same.
+		const T normal{item == T{} ? T{} : item};
+		if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+			return mix_hash(std::bit_cast<std::uint32_t>(normal));
+		}
+		else {
+			return mix_hash(std::bit_cast<std::uint64_t>(normal));
+		}
+	}
+	else if constexpr (std::is_enum_v<T>) {
+		return mix_hash(static_cast<std::uint64_t>(static_cast<std::underlying_type_t<T>>(item)));
+	}
+	else {
+		return mix_hash(static_cast<std::uint64_t>(item));
+	}
+}
+
+// distinct items of StaticArray::value, in order of first occurrence. built with an open addressing set, so it stays O(N) during
+// constant evaluation.
+template <typename StaticArray>
+constexpr auto distinct_items()
+{
+	using array_t = unwrap_static_array_t<StaticArray>;
+	using item_t = remove_all_extents_t<array_t>;
+	constexpr auto slots{std::bit_ceil(2 * total_items_v<array_t>)};
+
+	struct result_t {
+		std::array<item_t, total_items_v<array_t>> items;
+		std::size_t count;
+	};
+
+	result_t result{{}, 0};
+	std::array<item_t, slots> set{};
+	std::array<bool, slots> used{};
+
+	for_each_run(StaticArray::value, [&](auto run, std::size_t) {
+		for (const auto& item : run) {
+			auto slot{item_hash(item) & (slots - 1)};
+			while (used[slot] && not (set[slot] == item)) {
+				slot = (slot + 1) & (slots - 1);
+			}
+			if (not used[slot]) {
+				used[slot] = true;
+				set[slot] = item;
+				result.items[result.count++] = item;
+			}
+		}
+	});
+	return result;
+}
+
+// perfect hash from each distinct item of an array to the ascending offsets holding it. D distinct items are hashed into R buckets, and
+// each bucket gets a displacement that sends its items to free slots of a table with S slots (hash-and-displace). a lookup is two
+// hashes, one key compare and a slice of the offset list - O(1), no allocation, and everything lives in the (constexpr) object.
+template <hashable_item T, index_sequence Extents, std::size_t D, std::size_t R, std::size_t S>
+struct value_index {
+	using extents_type = Extents;
+	using value_type = T;
+
+	inline static constexpr auto total{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+		return (std::size_t{1} * ... * Es);
+	}(Extents{})};
+
+	// first[S] == total, so the offset type has to hold one past the last offset.
+	using offset_type = least_offset_t<total + 1>;
+
+	std::array<std::uint32_t, R> displacements;
+	std::array<T, S> keys;
+	std::array<bool, S> used;
+	// offsets of the item in slot s: offsets[first[s]] ... offsets[first[s + 1] - 1]
+	std::array<offset_type, S + 1> first;
+	std::array<offset_type, total> offsets;
+
+	static constexpr std::size_t bucket(std::uint64_t hash)
+	{
+		return static_cast<std::size_t>(hash % R);
+	}
+
+	static constexpr std::size_t slot(std::uint64_t hash, std::uint32_t displacement)
+	{
+		return static_cast<std::size_t>(mix_hash(hash ^ (0x9e3779b97f4a7c15ull * (displacement + 1ull))) & (S - 1));
+	}
+
+	constexpr std::size_t slot_of(const T& item) const
+	{
+		const auto hash{item_hash(item)};
+		return slot(hash, displacements[bucket(hash)]);
+	}
+
+	// ascending offsets of the items equal to item - empty if there are none.
+	constexpr std::span<const offset_type> find(const T& item) const
+	{
+		const auto s{slot_of(item)};
+		if (not used[s] || not (keys[s] == item)) {
+			return {};
+		}
+		return std::span{offsets}.subspan(first[s], static_cast<std::size_t>(first[s + 1] - first[s]));
+	}
+
+	constexpr bool contains(const T& item) const
+	{
+		return not find(item).empty();
+	}
+
+	constexpr std::size_t count(const T& item) const
+	{
+		return find(item).size();
+	}
+};
+
+template <typename StaticArray>
+constexpr auto index_values()
+{
+	using array_t = unwrap_static_array_t<StaticArray>;
+	using item_t = remove_all_extents_t<array_t>;
+	constexpr auto distinct{distinct_items<StaticArray>()};
+	constexpr auto D{distinct.count};
+	constexpr auto R{(D + 3) / 4};
+	constexpr auto S{std::bit_ceil(D + D / 4 + 1)};
+	using index_t = value_index<item_t, extents_of_t<array_t>, D, R, S>;
+
+	index_t result{{}, {}, {}, {}, {}};
+
+	// bucket the keys, then place the biggest buckets first while the table is still empty.
+	std::array<std::size_t, R + 1> bucket_first{};
+	std::array<std::size_t, D> bucket_keys{};
+	for (std::size_t k{0}; k < D; ++k) {
+		++bucket_first[index_t::bucket(item_hash(distinct.items[k])) + 1];
+	}
+	for (std::size_t b{0}; b < R; ++b) {
+		bucket_first[b + 1] += bucket_first[b];
+	}
+	{
+		auto fill{bucket_first};
+		for (std::size_t k{0}; k < D; ++k) {
+			bucket_keys[fill[index_t::bucket(item_hash(distinct.items[k]))]++] = k;
+		}
+	}
+
+	std::array<std::size_t, R> order{};
+	for (std::size_t b{0}; b < R; ++b) {
+		order[b] = b;
+	}
+	std::sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+		return bucket_first[lhs + 1] - bucket_first[lhs] > bucket_first[rhs + 1] - bucket_first[rhs];
+	});
+
+	for (const auto b : order) {
+		const auto size{bucket_first[b + 1] - bucket_first[b]};
+		std::array<std::size_t, 32> placed{};
+		if (size > placed.size()) {
+			throw std::logic_error{"index_values: bucket too large"};
+		}
+		for (std::uint32_t displacement{0};; ++displacement) {
+			if (displacement == std::uint32_t{1} << 24) {
+				throw std::logic_error{"index_values: no displacement found"};
+			}
+
+			bool fits{true};
+			for (std::size_t i{0}; fits && i < size; ++i) {
+				const auto s{index_t::slot(item_hash(distinct.items[bucket_keys[bucket_first[b] + i]]), displacement)};
+				fits = not result.used[s];
+				for (std::size_t j{0}; fits && j < i; ++j) {
+					fits = placed[j] != s;
+				}
+				placed[i] = s;
+			}
+			if (fits) {
+				result.displacements[b] = displacement;
+				for (std::size_t i{0}; i < size; ++i) {
+					result.used[placed[i]] = true;
+					result.keys[placed[i]] = distinct.items[bucket_keys[bucket_first[b] + i]];
+				}
+				break;
+			}
+		}
+	}
+
+	// group the offsets by slot, keeping them ascending within each slot.
+	using offset_t = typename index_t::offset_type;
+	std::array<std::size_t, S + 1> first{};
+	for_each_run(StaticArray::value, [&](auto run, std::size_t) {
+		for (const auto& item : run) {
+			++first[result.slot_of(item) + 1];
+		}
+	});
+	for (std::size_t s{0}; s < S; ++s) {
+		first[s + 1] += first[s];
+		result.first[s + 1] = static_cast<offset_t>(first[s + 1]);
+	}
+	for_each_run(StaticArray::value, [&](auto run, std::size_t offset) {
+		for (std::size_t i{0}; i < run.size(); ++i) {
+			result.offsets[first[result.slot_of(run[i])]++] = static_cast<offset_t>(offset + i);
+		}
+	});
+	return result;
+}
+
+}//metarray
@@ -1,14 +1,208 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #include "metarray.hpp"
+#if defined(METARRAY_INSTRUMENT)
+#include <chrono>
+#include <string_view>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
 
 namespace metarray {
 
+// --- runtime support ---------------------------------------------------------------------------------------------------------------------
+// width of the widest vector register the target was compiled for. runtime kernels process items in blocks of simd_lanes_v<T>
+// independent lanes (plain std::arrays) which the optimizer maps onto those registers.
+#if defined(__AVX512F__)
+inline constexpr std::size_t simd_bytes{64};
+#elif defined(__AVX__)
+inline constexpr std::size_t simd_bytes{32};
+#else
+inline constexpr std::size_t simd_bytes{16};
+#endif
+
+template <typename T>
+inline constexpr std::size_t simd_lanes_v{sizeof(T) < simd_bytes ? simd_bytes / sizeof(T) : 1};
+
+// visits the items of a in blocks of Lanes consecutive items of one run: f(block, offset, valid), block a std::span of Lanes items whose
+// first valid ones are the items from offset on. valid is a std::integral_constant for whole blocks, so per-lane masks like
+// "l < valid" fold away there, and a std::size_t for the last, partial block of a run. that block is read in place when the run is
+// padded far enough (custom arrays with for_each_padded_run, e.g. padded_array rows), otherwise from a copy filled up with T{}.
+template <std::size_t Lanes, array A, typename F>
+constexpr void for_each_block(const A& a, F&& f)
+{
+	using item_t = remove_all_extents_t<A>;
+	const auto visit{[&f](auto run, std::size_t offset, std::size_t items) {
+		std::size_t i{0};
+		for (; i + Lanes <= items; i += Lanes) {
+			f(run.subspan(i).template first<Lanes>(), offset + i, std::integral_constant<std::size_t, Lanes>{});
+		}
+		if (i == items) {
+			return;
+		}
+		if (i + Lanes <= run.size()) {
+			f(run.subspan(i).template first<Lanes>(), offset + i, items - i);
+		}
+		else {
+			std::array<item_t, Lanes> tail{};
+			for (std::size_t l{0}; l < Lanes; ++l) {
+				tail[l] = i + l < items ? run[i + l] : item_t{};
+			}
+			f(std::span<const item_t, Lanes>{tail}, offset + i, items - i);
+		}
+	}};
+
+	if constexpr (custom_array_with_padded_runs<A>) {
+		a.for_each_padded_run(visit);
+	}
+	else {
+		for_each_run(a, [&visit](auto run, std::size_t offset) { visit(run, offset, run.size()); });
+	}
+}
+
+template <array A, std::size_t...Is>
+constexpr std::size_t product_of_extents(const std::index_sequence<Is...>&)
+{
+	return (std::size_t{1} * ... * extent_v<A, Is>);
+}
+
+// axis-wise algorithms view an array as [outer_items_v][extent_v<A, Axis>][inner_items_v] in offset order.
+template <array A, std::size_t Axis>
+requires (Axis < rank_v<A>)
+inline constexpr auto outer_items_v{product_of_extents<A>(std::make_index_sequence<Axis>{})};
+
+template <array A, std::size_t Axis>
+requires (Axis < rank_v<A>)
+inline constexpr auto inner_items_v{total_items_v<A> / (outer_items_v<A, Axis> * extent_v<A, Axis>)};
+
+// minimum number of items a worker thread gets before a runtime algorithm bothers to go parallel.
+inline constexpr std::size_t parallel_grain{std::size_t{1} << 16};
+
+// when not 0, the number of workers every parallel runtime algorithm uses (at most extent_v<A, 0> still), regardless of the hardware
+// and of parallel_grain - so tests reach the parallel paths on any machine, or a program can pin its thread count. set it while no
+// algorithm is running.
+inline std::size_t parallel_workers_override{0};
+
+// number of workers used to split the outer extent of A. 1 means "stay on the calling thread".
+template <array A>
+std::size_t parallel_workers()
+{
+	if (parallel_workers_override != 0) {
+		return std::min(parallel_workers_override, extent_v<A, 0>);
+	}
+	const std::size_t hw{std::max(std::thread::hardware_concurrency(), 1u)};
+	return std::max(std::min({hw, extent_v<A, 0>, total_items_v<A> / parallel_grain}), std::size_t{1});
+}
+
+// splits [0, extent_v<A, 0>) into one contiguous chunk per worker: f(worker, first, last) on separate threads.
+template <array A, typename F>
+void parallel_for_outer(std::size_t workers, F f)
+{
+	std::vector<std::jthread> threads{};
+	threads.reserve(workers);
+	for (std::size_t w{0}; w < workers; ++w) {
+		threads.emplace_back(f, w, extent_v<A, 0> * w / workers, extent_v<A, 0> * (w + 1) / workers);
+	}
+}
+
+// --- instrumentation ---------------------------------------------------------------------------------------------------------------------
+// building with METARRAY_INSTRUMENT defined (for the whole program) makes the runtime calls of the main algorithms report an
+// algorithm_call each to instrument_sink. without it, instrument_scope is an empty type and the hooks compile to nothing. calls made
+// during constant evaluation are never reported.
+#if defined(METARRAY_INSTRUMENT)
+inline constexpr bool instrumented{true};
+
+struct algorithm_call {
+	std::string_view algorithm;
+	std::span<const std::size_t> extents;
+	std::size_t items;// items the algorithm visited
+	std::size_t bytes;// bytes of those items, plus any offset/value buffers
+	std::uint64_t cycles;// time stamp counter ticks on x86, nanoseconds elsewhere
+};
+
+// called at the end of every instrumented call, from the calling thread - so it must be thread safe if algorithms run concurrently.
+// nullptr turns reporting off.
+inline void (*instrument_sink)(const algorithm_call&){nullptr};
+
+inline std::uint64_t cycle_count()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+#else
+inline constexpr bool instrumented{false};
+#endif
+
+template <array A>
+inline constexpr auto extents_array_v{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+	return std::array<std::size_t, sizeof...(Es)>{Es...};
+}(extents_of_t<A>{})};
+
+// reports the enclosing call of algorithm over an array A when it goes out of scope. by default the call visits every item of A once.
+template <array A, bool = instrumented>
+class instrument_scope {
+public:
+	explicit constexpr instrument_scope(const char*, std::size_t = 0, std::size_t = 0) {}
+};
+
+#if defined(METARRAY_INSTRUMENT)
+template <array A>
+class instrument_scope<A, true> {
+public:
+	explicit constexpr instrument_scope(const char* algorithm, std::size_t items = total_items_v<A>,
+		std::size_t bytes = total_items_v<A> * sizeof(remove_all_extents_t<A>))
+		: algorithm_{algorithm}
+		, items_{items}
+		, bytes_{bytes}
+		, start_{0}
+	{
+		if !consteval {
+			start_ = cycle_count();
+		}
+	}
+
+	instrument_scope(const instrument_scope&) = delete;
+	instrument_scope& operator=(const instrument_scope&) = delete;
+
+	constexpr ~instrument_scope()
+	{
+		if !consteval {
+			if (const auto sink{instrument_sink}; sink != nullptr) {
+				sink({algorithm_, extents_array_v<A>, items_, bytes_, cycle_count() - start_});
+			}
+		}
+	}
+
+private:
+	const char* algorithm_;
+	std::size_t items_;
+	std::size_t bytes_;
+	std::uint64_t start_;
+};
+#endif
+
 // --- transformation ----------------------------------------------------------------------------------------------------------------------
 //TODO: shouldn't need std::remove_cvref_t here. lower level types should work with or without it.
 template <typename StaticArray>
@@ -33,41 +227,369 @@ static_transform_to_array(const std::tuple<Idx...>& idx)
 	return static_transform_to_array<StaticArray, Idx...>(idx, std::make_index_sequence<sizeof...(Idx)>{});
 }
 
-// --- algorithms/numerics -----------------------------------------------------------------------------------------------------------------
-template <typename StaticArray, typename Pred, std::size_t I, valid_indexer...Idx>
-requires ((I == sizeof...(Idx) - 1) && (is_valid_indexer_of_v<unwrap_static_array_t<StaticArray>, Idx> && ...))
-constexpr auto static_find_if(const std::tuple<Idx...>& idx, Pred pred)
+template <index_sequence Extents, auto Offsets, std::size_t...Is>
+constexpr auto static_indexers_from_offsets(const std::index_sequence<Is...>&)
 {
-	using IdxN = std::remove_reference_t<decltype(std::get<I>(idx))>;
-	constexpr auto item{get<IdxN>(StaticArray::value)};
+	return std::tuple<indexer_from_offset_t<Offsets[Is], Extents>...>{};
+}
+
+// tuple of the indexer types at the first N of a constexpr array of offsets - how algorithms that run as one constexpr loop over offsets
+// hand their results back as types.
+template <index_sequence Extents, auto Offsets, std::size_t N = Offsets.size()>
+using indexers_from_offsets_t = decltype(static_indexers_from_offsets<Extents, Offsets>(std::make_index_sequence<N>{}));
+
+// items of any array in offset order, as a flat std::array.
+template <array A>
+constexpr std::array<remove_all_extents_t<A>, total_items_v<A>> flatten(const A& a)
+{
+	std::array<remove_all_extents_t<A>, total_items_v<A>> result{};
+
+	for_each_run(a, [&result](auto run, std::size_t offset) {
+		std::copy(run.begin(), run.end(), result.begin() + static_cast<std::ptrdiff_t>(offset));
+	});
+	return result;
+}
 
-	if constexpr (pred(item)) {
-		return std::make_tuple(IdxN{});
+// items generate handles per inner loop. gcc caps a single constant-evaluated loop at 2^18 iterations (-fconstexpr-loop-limit), so long
+// innermost rows take two loops rather than one.
+inline constexpr std::size_t generate_chunk{std::size_t{1} << 12};
+
+// A with every item set to f of its position. f takes whichever of these it accepts first:
+//   f(idx) - the runtime_indexer_of_t<A> of the item
+//   f(i, j, ...) - one std::size_t index per axis
+//   f(offset) - the row-major offset of the item
+// c-arrays come back as the equivalent nested std::arrays. plain loops, innermost row by innermost row - no recursion over indexer types,
+// so tables of 100k+ items can be constexpr variables (and end up in .rodata) without running into template depth limits.
+template <array A, typename F>
+requires (std::is_default_constructible_v<A>)
+constexpr auto generate(F f)
+{
+	const instrument_scope<A> instrument{"generate"};
+	using idx_t = runtime_indexer_of_t<A>;
+	using item_t = remove_all_extents_t<A>;
+	using result_t = std::conditional_t<c_array<A>, std_array_of_t<item_t, extents_of_t<A>>, A>;
+	constexpr auto extents{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+		return std::array<std::size_t, sizeof...(Es)>{Es...};
+	}(extents_of_t<A>{})};
+	constexpr auto row_items{extents.back()};
+	constexpr bool by_indices{[]<std::size_t...Rs>(const std::index_sequence<Rs...>&) {
+		return std::invocable<F&, decltype(Rs, std::size_t{})...>;
+	}(std::make_index_sequence<rank_v<A>>{})};
+
+	// items [offset, offset + items) of whole innermost rows, through item(offset) or a writable run that holds them
+	const auto fill{[&f, &extents, row_items](auto&& item, std::size_t offset, std::size_t items) {
+		auto idx{runtime_indexer_from_offset<extents_of_t<A>>(offset)};
+		for (std::size_t row{offset}; row < offset + items; row += row_items) {
+			for (std::size_t first{0}; first < row_items; first += generate_chunk) {
+				// the indices expand once per chunk rather than once per item - constant evaluation counts every call
+				[&]<std::size_t...Rs>(const std::index_sequence<Rs...>&) {
+					const auto last{std::min(first + generate_chunk, row_items)};
+					const std::size_t outer[]{idx.index[Rs]...};
+					for (std::size_t i{first}; i < last; ++i) {
+						if constexpr (std::invocable<F&, const idx_t&>) {
+							idx.index[rank_v<A> - 1] = i;
+							item(row + i) = static_cast<item_t>(f(std::as_const(idx)));
+						}
+						else if constexpr (by_indices) {
+							item(row + i) = static_cast<item_t>(f((Rs + 1 < rank_v<A> ? outer[Rs] : i)...));
+						}
+						else {
+							item(row + i) = static_cast<item_t>(f(row + i));
+						}
+					}
+				}(std::make_index_sequence<rank_v<A>>{});
+			}
+			for (std::size_t r{rank_v<A> - 1}; r-- > 0;) {
+				if (++idx.index[r] < extents[r]) {
+					break;
+				}
+				idx.index[r] = 0;
+			}
+		}
+	}};
+
+	result_t result{};
+	if constexpr (custom_array<result_t> && not custom_array_with_runs<result_t>) {
+		// for_each_run would only hand out copies
+		fill(offset_accessor(result), 0, total_items_v<A>);
 	}
 	else {
-		return std::make_tuple();
+		for_each_run(result, [&fill](auto run, std::size_t offset) {
+			fill([data = run.data(), offset](std::size_t o) -> auto& { return data[o - offset]; }, offset, run.size());
+		});
 	}
+	return result;
 }
 
-template <typename StaticArray, typename Pred, std::size_t I, valid_indexer...Idx>
-requires ((I < sizeof...(Idx) - 1) && (is_valid_indexer_of_v<unwrap_static_array_t<StaticArray>, Idx> && ...))
-constexpr auto static_find_if(const std::tuple<Idx...>& idx, Pred pred)
+// indexers a gather or scatter converts to offsets at a time.
+inline constexpr std::size_t gather_block{64};
+
+// the loops of gather and scatter by offset, unreported - the indexer overloads run them block by block and report once for the
+// whole call.
+template <array A>
+constexpr void gather_offsets(const A& a, std::span<const std::size_t> offsets, std::span<remove_all_extents_t<A>> out)
 {
-	using IdxN = std::remove_reference_t<decltype(std::get<I>(idx))>;
-	constexpr auto item{get<IdxN>(StaticArray::value)};
+	auto item{offset_accessor(a)};
+	for (std::size_t i{0}; i < offsets.size(); ++i) {
+		out[i] = item(offsets[i]);
+	}
+}
 
-	if constexpr (pred(item)) {
-		return std::tuple_cat(std::make_tuple(IdxN{}), static_find_if<StaticArray, Pred, I + 1>(idx, pred));
+template <array A>
+constexpr void scatter_offsets(A& a, std::span<const std::size_t> offsets, std::span<const remove_all_extents_t<A>> values)
+{
+	auto item{offset_accessor(a)};
+	for (std::size_t i{0}; i < offsets.size(); ++i) {
+		item(offsets[i]) = values[i];
 	}
-	else {
-		return static_find_if<StaticArray, Pred, I + 1>(idx, pred);
+}
+
+// out[i] = the item at offsets[i]; out must be at least as long as offsets. the loads are independent of each other, so out of order
+// execution already overlaps their cache misses - neither software prefetching nor hardware gather instructions made random batches any
+// faster.
+template <array A>
+constexpr void gather(const A& a, std::span<const std::size_t> offsets, std::span<remove_all_extents_t<A>> out)
+{
+	const instrument_scope<A> instrument{"gather", offsets.size(),
+		offsets.size() * (sizeof(std::size_t) + 2 * sizeof(remove_all_extents_t<A>))};
+	assert(out.size() >= offsets.size());
+	gather_offsets(a, offsets, out);
+}
+
+// out[i] = the item at idxs[i]; out must be at least as long as idxs. the indexers are converted gather_block at a time with
+// runtime_offsets_from_indexers, which vectorizes.
+template <array A>
+constexpr void gather(const A& a, std::span<const runtime_indexer_of_t<A>> idxs, std::span<remove_all_extents_t<A>> out)
+{
+	const instrument_scope<A> instrument{"gather", idxs.size(),
+		idxs.size() * (sizeof(runtime_indexer_of_t<A>) + 2 * sizeof(remove_all_extents_t<A>))};
+	assert(out.size() >= idxs.size());
+	std::array<std::size_t, gather_block> offsets{};
+	for (std::size_t first{0}; first < idxs.size(); first += gather_block) {
+		const auto n{std::min(gather_block, idxs.size() - first)};
+		runtime_offsets_from_indexers<extents_of_t<A>>(idxs.subspan(first, n), offsets);
+		gather_offsets(a, std::span<const std::size_t>{offsets.data(), n}, out.subspan(first, n));
+	}
+}
+
+// the item at offsets[i] = values[i]; values must be at least as long as offsets. if an offset repeats, the last of its values wins.
+template <array A>
+constexpr void scatter(A& a, std::span<const std::size_t> offsets, std::span<const remove_all_extents_t<A>> values)
+{
+	const instrument_scope<A> instrument{"scatter", offsets.size(),
+		offsets.size() * (sizeof(std::size_t) + 2 * sizeof(remove_all_extents_t<A>))};
+	assert(values.size() >= offsets.size());
+	scatter_offsets(a, offsets, values);
+}
+
+// the item at idxs[i] = values[i]; values must be at least as long as idxs. if an indexer repeats, the last of its values wins.
+template <array A>
+constexpr void scatter(A& a, std::span<const runtime_indexer_of_t<A>> idxs, std::span<const remove_all_extents_t<A>> values)
+{
+	const instrument_scope<A> instrument{"scatter", idxs.size(),
+		idxs.size() * (sizeof(runtime_indexer_of_t<A>) + 2 * sizeof(remove_all_extents_t<A>))};
+	assert(values.size() >= idxs.size());
+	std::array<std::size_t, gather_block> offsets{};
+	for (std::size_t first{0}; first < idxs.size(); first += gather_block) {
+		const auto n{std::min(gather_block, idxs.size() - first)};
+		runtime_offsets_from_indexers<extents_of_t<A>>(idxs.subspan(first, n), offsets);
+		scatter_offsets(a, std::span<const std::size_t>{offsets.data(), n}, values.subspan(first, n));
+	}
+}
+
+// --- tiling -----------------------------------------------------------------------------------------------------------------------------
+// bytes of one tile. a tile of a source and one of a destination array fit in a 32KiB L1 data cache together.
+inline constexpr std::size_t tile_bytes{std::size_t{1} << 14};
+
+// default tile extents of A: the largest power of two E with E^rank items in tile_bytes, clamped to each extent.
+template <array A, std::size_t...Is>
+constexpr auto default_tile_extents(const std::index_sequence<Is...>&)
+{
+	std::size_t edge{1};
+	const auto items{[](std::size_t e) {
+		std::size_t n{1};
+		for (std::size_t r{0}; r < rank_v<A>; ++r) {
+			n *= e;
+		}
+		return n;
+	}};
+	while (items(edge * 2) * sizeof(remove_all_extents_t<A>) <= tile_bytes) {
+		edge *= 2;
+	}
+	return std::array<std::size_t, rank_v<A>>{std::min(edge, extent_v<A, Is>)...};
+}
+
+template <typename...>
+struct tile_extents;
+
+template <array A, std::size_t...Is>
+struct tile_extents<A, std::index_sequence<Is...>> {
+	inline static constexpr auto tiles{default_tile_extents<A>(std::index_sequence<Is...>{})};
+	using type = std::index_sequence<tiles[Is]...>;
+};
+
+template <array A>
+using tile_extents_t = tile_extents<A, std::make_index_sequence<rank_v<A>>>::type;
+
+// advances idx in row-major order over the box [first, last) in steps of step along each axis. false once it wraps around to first.
+template <std::size_t N>
+constexpr bool next_index(std::array<std::size_t, N>& idx, const std::array<std::size_t, N>& first, const std::array<std::size_t, N>& last,
+	const std::array<std::size_t, N>& step)
+{
+	for (std::size_t r{N}; r-- > 0;) {
+		idx[r] += step[r];
+		if (idx[r] < last[r]) {
+			return true;
+		}
+		idx[r] = first[r];
+	}
+	return false;
+}
+
+// visits A tile by tile: f(first, extents) with the runtime indexer of the tile's first item and the tile's extents - smaller than Tiles
+// along an axis where the array's extent isn't a multiple of the tile's. tiles are visited in row-major order, so within a row of tiles
+// a kernel works on a block of every axis at once instead of streaming through whole rows.
+template <array A, index_sequence Tiles = tile_extents_t<A>, typename F>
+requires (Tiles::size() == rank_v<A>)
+constexpr void for_each_tile(F&& f)
+{
+	constexpr auto extents{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+		return std::array<std::size_t, sizeof...(Es)>{Es...};
+	}(extents_of_t<A>{})};
+	constexpr auto tiles{[]<std::size_t...Ts>(const std::index_sequence<Ts...>&) {
+		return std::array<std::size_t, sizeof...(Ts)>{Ts...};
+	}(Tiles{})};
+	static_assert(std::ranges::all_of(tiles, [](std::size_t t) { return t > 0; }), "tile extents can't be 0");
+
+	runtime_indexer_of_t<A> first{};
+	std::array<std::size_t, rank_v<A>> tile_extents{};
+	do {
+		for (std::size_t r{0}; r < rank_v<A>; ++r) {
+			tile_extents[r] = std::min(tiles[r], extents[r] - first.index[r]);
+		}
+		f(std::as_const(first), std::as_const(tile_extents));
+	} while (next_index(first.index, {}, extents, tiles));
+}
+
+template <index_sequence Tiles, array A, typename F>
+constexpr void for_each_tile(const A&, F&& f)
+{
+	for_each_tile<A, Tiles>(std::forward<F>(f));
+}
+
+template <array A, typename F>
+constexpr void for_each_tile(const A&, F&& f)
+{
+	for_each_tile<A>(std::forward<F>(f));
+}
+
+// row-major offsets of all items of A in tiled order: tile by tile, row-major within each tile.
+template <array A, index_sequence Tiles = tile_extents_t<A>>
+constexpr auto tiled_offsets()
+{
+	std::array<std::size_t, total_items_v<A>> result{};
+	std::size_t n{0};
+	for_each_tile<A, Tiles>([&](const runtime_indexer_of_t<A>& first, const std::array<std::size_t, rank_v<A>>& tile_extents) {
+		std::array<std::size_t, rank_v<A>> last{};
+		std::array<std::size_t, rank_v<A>> step{};
+		for (std::size_t r{0}; r < rank_v<A>; ++r) {
+			last[r] = first.index[r] + tile_extents[r];
+			step[r] = 1;
+		}
+
+		auto idx{first};
+		do {
+			result[n++] = runtime_offset_from_indexer(idx);
+		} while (next_index(idx.index, first.index, last, step));
+	});
+	return result;
+}
+
+// indexer types of all items of A in tiled order - a drop-in for indexer_list_of_t in the static algorithms.
+template <array A, index_sequence Tiles = tile_extents_t<A>>
+using tiled_indexer_list_of_t = indexers_from_offsets_t<extents_of_t<A>, tiled_offsets<A, Tiles>()>;
+
+// a[i][j] -> result[j][i], copied tile by tile so neither the reads nor the writes stride through whole columns.
+template <array A>
+requires (rank_v<A> == 2)
+constexpr std_array_of_t<remove_all_extents_t<A>, std::index_sequence<extent_v<A, 1>, extent_v<A, 0>>> transpose(const A& a)
+{
+	const instrument_scope<A> instrument{"transpose", total_items_v<A>, 2 * total_items_v<A> * sizeof(remove_all_extents_t<A>)};
+	std_array_of_t<remove_all_extents_t<A>, std::index_sequence<extent_v<A, 1>, extent_v<A, 0>>> result{};
+	auto item{offset_accessor(a)};
+	auto result_item{offset_accessor(result)};
+
+	for_each_tile(a, [&](const runtime_indexer_of_t<A>& first, const std::array<std::size_t, 2>& tile_extents) {
+		for (std::size_t i{first.index[0]}; i < first.index[0] + tile_extents[0]; ++i) {
+			for (std::size_t j{first.index[1]}; j < first.index[1] + tile_extents[1]; ++j) {
+				result_item(j * extent_v<A, 0> + i) = item(i * extent_v<A, 1> + j);
+			}
+		}
+	});
+	return result;
+}
+
+// --- algorithms/numerics -----------------------------------------------------------------------------------------------------------------
+// offsets of the items matching pred, listed in indexer_list_of_t order (the first index varies fastest). pred runs in one constexpr pass
+// over the items and has to be usable in constant expressions (e.g. a lambda without captures).
+template <typename StaticArray, typename Pred>
+constexpr auto static_find_offsets(Pred pred)
+{
+	using array_t = unwrap_static_array_t<StaticArray>;
+	constexpr auto extents{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+		return std::array<std::size_t, sizeof...(Es)>{Es...};
+	}(extents_of_t<array_t>{})};
+
+	std::array<bool, total_items_v<array_t>> matches{};
+	for_each_run(StaticArray::value, [&](auto run, std::size_t offset) {
+		for (std::size_t i{0}; i < run.size(); ++i) {
+			matches[offset + i] = pred(run[i]);
+		}
+	});
+
+	struct result_t {
+		std::array<std::size_t, total_items_v<array_t>> offsets;
+		std::size_t count;
+	};
+
+	// walk the row-major offsets in indexer order with an odometer over the indices.
+	result_t result{{}, 0};
+	std::array<std::size_t, extents.size()> idx{};
+	std::array<std::size_t, extents.size()> strides{};
+	strides.back() = 1;
+	for (std::size_t r{extents.size() - 1}; r-- > 0;) {
+		strides[r] = strides[r + 1] * extents[r + 1];
 	}
+
+	std::size_t offset{0};
+	for (std::size_t n{0}; n < total_items_v<array_t>; ++n) {
+		if (matches[offset]) {
+			result.offsets[result.count++] = offset;
+		}
+		for (std::size_t r{0}; r < extents.size(); ++r) {
+			offset += strides[r];
+			if (++idx[r] < extents[r]) {
+				break;
+			}
+			offset -= extents[r] * strides[r];
+			idx[r] = 0;
+		}
+	}
+	return result;
 }
 
+// indexer types of the items matching pred, in indexer_list_of_t order. the predicate runs in a single constexpr loop, so only the matches are
+// instantiated as types - compile time and template depth no longer grow with the array.
 template <typename StaticArray, typename Pred>
 constexpr auto static_find_if(Pred pred)
 {
-	return static_find_if<StaticArray, Pred, 0>(indexer_list_of_t<unwrap_static_array_t<StaticArray>>{}, pred);
+	constexpr auto found{static_find_offsets<StaticArray>(pred)};
+	constexpr auto offsets{[&found] {
+		std::array<std::size_t, found.count> result{};
+		std::copy_n(found.offsets.begin(), found.count, result.begin());
+		return result;
+	}()};
+	return indexers_from_offsets_t<extents_of_t<unwrap_static_array_t<StaticArray>>, offsets>{};
 }
 
 template <typename StaticArray, std::size_t I, std::size_t M, valid_indexer...Idx>
@@ -138,6 +660,7 @@ constexpr T accumulate(const A& a, const std::tuple<Idx...>& idx, T init, BinOp
 template <array A, typename T, typename BinOp>
 constexpr T accumulate(const A& a, T init, BinOp op)
 {
+	const instrument_scope<A> instrument{"accumulate"};
 	return accumulate<A, T, BinOp, 0>(a, indexer_list_of_t<A>{}, init, op);
 }
 
@@ -151,6 +674,7 @@ constexpr auto sum(const A& a, const std::tuple<Idx...>&)
 template <array A>
 constexpr auto sum(const A& a)
 {
+	const instrument_scope<A> instrument{"sum"};
 	return sum(a, indexer_list_of_t<A>{});
 }
 
@@ -164,7 +688,1205 @@ constexpr auto product(const A& a, const std::tuple<Idx...>&)
 template <array A>
 constexpr auto product(const A& a)
 {
+	const instrument_scope<A> instrument{"product"};
 	return product(a, indexer_list_of_t<A>{});
 }
 
+
+// --- algorithms/fused reductions --------------------------------------------------------------------------------------------------------
+// reducers for reduce_many. a reducer provides:
+//   init<T>() - the starting state for items of type T
+//   r(state, item) - the state after one more item
+//   merge(state, state) - two partial states combined
+// the final state is the result.
+struct sum_reducer {
+	template <typename T>
+	constexpr auto init() const
+	{
+		return decltype(T{} + T{}){};
+	}
+
+	template <typename S, typename T>
+	constexpr S operator()(S state, const T& item) const
+	{
+		return state + item;
+	}
+
+	template <typename S>
+	constexpr S merge(S lhs, S rhs) const
+	{
+		return lhs + rhs;
+	}
+};
+
+// min_reducer and max_reducer start from the extreme value of T, so they only take types with numeric_limits.
+struct min_reducer {
+	template <typename T>
+	requires (std::numeric_limits<T>::is_specialized)
+	constexpr T init() const
+	{
+		return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+	}
+
+	template <typename T>
+	constexpr T operator()(T state, const T& item) const
+	{
+		return item < state ? item : state;
+	}
+
+	template <typename T>
+	constexpr T merge(T lhs, T rhs) const
+	{
+		return rhs < lhs ? rhs : lhs;
+	}
+};
+
+struct max_reducer {
+	template <typename T>
+	requires (std::numeric_limits<T>::is_specialized)
+	constexpr T init() const
+	{
+		return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+	}
+
+	template <typename T>
+	constexpr T operator()(T state, const T& item) const
+	{
+		return state < item ? item : state;
+	}
+
+	template <typename T>
+	constexpr T merge(T lhs, T rhs) const
+	{
+		return lhs < rhs ? rhs : lhs;
+	}
+};
+
+template <typename Pred>
+struct count_if_reducer {
+	Pred pred;
+
+	template <typename T>
+	constexpr std::size_t init() const
+	{
+		return 0;
+	}
+
+	template <typename T>
+	constexpr std::size_t operator()(std::size_t state, const T& item) const
+	{
+		return state + (pred(item) ? 1u : 0u);
+	}
+
+	constexpr std::size_t merge(std::size_t lhs, std::size_t rhs) const
+	{
+		return lhs + rhs;
+	}
+};
+
+template <typename Pred>
+count_if_reducer(Pred) -> count_if_reducer<Pred>;
+
+// any associative op, starting from init (which has to be neutral, since every lane starts from it).
+template <typename T, typename BinOp>
+struct fold_reducer {
+	T init_value;
+	BinOp op;
+
+	template <typename>
+	constexpr T init() const
+	{
+		return init_value;
+	}
+
+	template <typename Item>
+	constexpr T operator()(T state, const Item& item) const
+	{
+		return op(state, item);
+	}
+
+	constexpr T merge(T lhs, T rhs) const
+	{
+		return op(lhs, rhs);
+	}
+};
+
+template <typename T, typename BinOp>
+fold_reducer(T, BinOp) -> fold_reducer<T, BinOp>;
+
+// results of all reducers over the items of a, in a single traversal. every reducer keeps simd_lanes_v<T> partial states and steps all
+// of them in the same loop body, so the loop vectorizes as a whole and the items are read from memory only once.
+template <array A, typename...Reducers>
+requires (sizeof...(Reducers) > 0)
+constexpr auto reduce_many(const A& a, const Reducers&...reducers)
+{
+	const instrument_scope<A> instrument{"reduce_many"};
+	using item_t = remove_all_extents_t<A>;
+	constexpr auto lanes{simd_lanes_v<item_t>};
+	constexpr auto each_reducer{[](auto f) {
+		[&f]<std::size_t...Rs>(const std::index_sequence<Rs...>&) {
+			(f(std::integral_constant<std::size_t, Rs>{}), ...);
+		}(std::index_sequence_for<Reducers...>{});
+	}};
+
+	const auto reducer_list{std::tie(reducers...)};
+	std::tuple<std::array<decltype(reducers.template init<item_t>()), lanes>...> states{};
+	each_reducer([&](auto r) {
+		std::get<r>(states).fill(std::get<r>(reducer_list).template init<item_t>());
+	});
+
+	for_each_block<lanes>(a, [&](auto block, std::size_t, auto valid) {
+		each_reducer([&](auto r) {
+			auto& state{std::get<r>(states)};
+			for (std::size_t l{0}; l < lanes; ++l) {
+				state[l] = l < valid ? std::get<r>(reducer_list)(state[l], block[l]) : state[l];
+			}
+		});
+	});
+
+	return [&]<std::size_t...Rs>(const std::index_sequence<Rs...>&) {
+		const auto result{[&](auto r) {
+			auto state{std::get<r>(states)[0]};
+			for (std::size_t l{1}; l < lanes; ++l) {
+				state = std::get<r>(reducer_list).merge(state, std::get<r>(states)[l]);
+			}
+			return state;
+		}};
+		return std::make_tuple(result(std::integral_constant<std::size_t, Rs>{})...);
+	}(std::index_sequence_for<Reducers...>{});
+}
+
+// --- algorithms/axis reductions ----------------------------------------------------------------------------------------------------------
+// result of reducing A along Axis: a std::array nested to rank_v<A> - 1, or just T when A has a single extent.
+template <array A, std::size_t Axis, typename T>
+using reduced_array_t = std_array_of_t<T, reduced_extents_of_t<A, Axis>>;
+
+// reduces each row of N consecutive items, rows Stride items apart: simd_lanes_v<T> lane accumulators walk the row, then get folded
+// horizontally. when the rows are padded past their last partial block of lanes, that block is read whole and masked.
+template <typename T, std::size_t Outer, std::size_t N, std::size_t Stride = N, typename Item, typename Result, typename BinOp>
+constexpr void reduce_inner(Item item, Result result, const std::optional<T>& init, BinOp op)
+{
+	constexpr auto lanes{simd_lanes_v<T>};
+
+	for (std::size_t o{0}; o < Outer; ++o) {
+		const auto row{o * Stride};
+		T acc{init ? op(*init, item(row)) : T(item(row))};
+		std::size_t n{1};
+
+		if constexpr (lanes > 1 && N >= 2 * lanes) {
+			std::array<T, lanes> x{};
+			for (std::size_t l{0}; l < lanes; ++l) {
+				x[l] = item(row + l);
+			}
+			for (n = lanes; n + lanes <= N; n += lanes) {
+				for (std::size_t l{0}; l < lanes; ++l) {
+					x[l] = op(x[l], item(row + n + l));
+				}
+			}
+			if constexpr (N % lanes != 0 && Stride >= (N / lanes + 1) * lanes) {
+				for (std::size_t l{0}; l < lanes; ++l) {
+					x[l] = n + l < N ? op(x[l], item(row + n + l)) : x[l];
+				}
+				n = N;
+			}
+			acc = init ? op(*init, x[0]) : x[0];
+			for (std::size_t l{1}; l < lanes; ++l) {
+				acc = op(acc, x[l]);
+			}
+		}
+		for (; n < N; ++n) {
+			acc = op(acc, item(row + n));
+		}
+		result(o) = acc;
+	}
+}
+
+// reduces along an outer axis: every row of Inner items is folded into the result row in one vectorizable sweep.
+template <typename T, std::size_t Outer, std::size_t N, std::size_t Inner, typename Item, typename Result, typename BinOp>
+constexpr void reduce_outer(Item item, Result result, const std::optional<T>& init, BinOp op)
+{
+	for (std::size_t o{0}; o < Outer; ++o) {
+		for (std::size_t i{0}; i < Inner; ++i) {
+			const auto first{item(o * N * Inner + i)};
+			result(o * Inner + i) = init ? op(*init, first) : T(first);
+		}
+		for (std::size_t n{1}; n < N; ++n) {
+			const auto row{(o * N + n) * Inner};
+			for (std::size_t i{0}; i < Inner; ++i) {
+				result(o * Inner + i) = op(result(o * Inner + i), item(row + i));
+			}
+		}
+	}
+}
+
+template <std::size_t Axis, array A, typename T, typename BinOp>
+requires (Axis < rank_v<A>)
+constexpr reduced_array_t<A, Axis, T> reduce_axis(const A& a, const std::optional<T>& init, BinOp op)
+{
+	const instrument_scope<A> instrument{"axis reduction"};
+	constexpr auto outer{outer_items_v<A, Axis>};
+	constexpr auto n{extent_v<A, Axis>};
+	constexpr auto inner{inner_items_v<A, Axis>};
+
+	std::conditional_t<rank_v<A> == 1, std::array<T, 1>, reduced_array_t<A, Axis, T>> result{};
+	auto item{offset_accessor(a)};
+	auto result_item{offset_accessor(result)};
+
+	if constexpr (inner == 1) {
+		reduce_inner<T, outer, n>(item, result_item, init, op);
+	}
+	else {
+		reduce_outer<T, outer, n, inner>(item, result_item, init, op);
+	}
+
+	if constexpr (rank_v<A> == 1) {
+		return result[0];
+	}
+	else {
+		return result;
+	}
+}
+
+// folds the items along Axis: result[..., ...] == op(init, a[..., 0, ...], ..., a[..., N - 1, ...]). op must be associative and
+// commutative - the items are folded into several lanes that are combined at the end, not strictly in order.
+template <std::size_t Axis, array A, typename T, typename BinOp>
+requires (Axis < rank_v<A>)
+constexpr reduced_array_t<A, Axis, T> reduce(const A& a, T init, BinOp op)
+{
+	return reduce_axis<Axis>(a, std::optional<T>{init}, op);
+}
+
+template <std::size_t Axis, array A>
+requires (Axis < rank_v<A>)
+constexpr auto sum(const A& a)
+{
+	// promoted like in sum(a), so narrow items don't wrap around
+	using sum_t = decltype(remove_all_extents_t<A>{} + remove_all_extents_t<A>{});
+	return reduce<Axis>(a, sum_t{}, std::plus<>{});
+}
+
+template <std::size_t Axis, array A>
+requires (Axis < rank_v<A>)
+constexpr auto min(const A& a)
+{
+	using item_t = remove_all_extents_t<A>;
+	return reduce_axis<Axis>(a, std::optional<item_t>{}, [](const item_t& lhs, const item_t& rhs) { return rhs < lhs ? rhs : lhs; });
+}
+
+template <std::size_t Axis, array A>
+requires (Axis < rank_v<A>)
+constexpr auto max(const A& a)
+{
+	using item_t = remove_all_extents_t<A>;
+	return reduce_axis<Axis>(a, std::optional<item_t>{}, [](const item_t& lhs, const item_t& rhs) { return lhs < rhs ? rhs : lhs; });
+}
+
+// --- algorithms/extrema -----------------------------------------------------------------------------------------------------------------
+// best item/offset seen by each of simd_lanes_v<T> lanes. a lane only moves on to an item that is strictly better, and lanes are merged
+// by value and then by lowest offset, so the first occurrence wins - same as static_find_min.
+template <typename T, typename Compare>
+struct arg_select_lanes {
+	inline static constexpr auto lanes{simd_lanes_v<T>};
+
+	std::array<T, lanes> values;
+	std::array<std::size_t, lanes> offsets;
+	Compare comp;
+
+	constexpr arg_select_lanes(const T& first, Compare c) : values{}, offsets{}, comp{c}
+	{
+		values.fill(first);
+	}
+
+	// masked lanes (not valid) keep their state.
+	constexpr void update(std::size_t lane, const T& item, std::size_t offset, bool valid)
+	{
+		const bool better{valid && comp(item, values[lane])};
+		values[lane] = better ? item : values[lane];
+		offsets[lane] = better ? offset : offsets[lane];
+	}
+
+	constexpr std::size_t offset() const
+	{
+		std::size_t best{0};
+		for (std::size_t l{1}; l < lanes; ++l) {
+			if (comp(values[l], values[best]) || (not comp(values[best], values[l]) && offsets[l] < offsets[best])) {
+				best = l;
+			}
+		}
+		return offsets[best];
+	}
+};
+
+template <array A, typename...Compare>
+constexpr auto arg_select(const A& a, Compare...comp)
+{
+	using item_t = remove_all_extents_t<A>;
+	constexpr auto width{simd_lanes_v<item_t>};
+	const item_t first{at_offset(a, 0)};
+
+	std::tuple<arg_select_lanes<item_t, Compare>...> lanes{arg_select_lanes<item_t, Compare>{first, comp}...};
+	for_each_block<width>(a, [&lanes](auto block, std::size_t offset, auto valid) {
+		std::apply([&](auto&...l) {
+			for (std::size_t lane{0}; lane < width; ++lane) {
+				(l.update(lane, block[lane], offset + lane, lane < valid), ...);
+			}
+		}, lanes);
+	});
+	return std::apply([](const auto&...l) {
+		return std::make_tuple(runtime_indexer_from_offset<extents_of_t<A>>(l.offset())...);
+	}, lanes);
+}
+
+// indexer of the first occurrence of the smallest item.
+template <array A>
+constexpr runtime_indexer_of_t<A> argmin(const A& a)
+{
+	const instrument_scope<A> instrument{"argmin"};
+	return std::get<0>(arg_select(a, std::less<>{}));
+}
+
+// indexer of the first occurrence of the largest item.
+template <array A>
+constexpr runtime_indexer_of_t<A> argmax(const A& a)
+{
+	const instrument_scope<A> instrument{"argmax"};
+	return std::get<0>(arg_select(a, std::greater<>{}));
+}
+
+// {argmin(a), argmax(a)} in a single pass. unlike std::minmax_element, ties for the largest item also go to the first occurrence.
+template <array A>
+constexpr std::pair<runtime_indexer_of_t<A>, runtime_indexer_of_t<A>> minmax_element(const A& a)
+{
+	const instrument_scope<A> instrument{"minmax_element"};
+	const auto [min, max]{arg_select(a, std::less<>{}, std::greater<>{})};
+	return {min, max};
+}
+
+// --- algorithms/selection ---------------------------------------------------------------------------------------------------------------
+// offsets of the K smallest items of an array whose innermost rows are each sorted ascending, smallest first. a min-heap holds the head
+// of every row, so this takes O(M + K log M) for M rows instead of rescanning all items K times. ties go to the smaller offset.
+// unsorted rows give an unspecified (but valid) selection.
+template <std::size_t K, array A>
+constexpr std::array<std::size_t, std::min(K, total_items_v<A>)> k_min_sorted_row_offsets(const A& a)
+{
+	using item_t = remove_all_extents_t<A>;
+	constexpr auto row_items{extent_v<A, rank_v<A> - 1>};
+	constexpr auto rows{total_items_v<A> / row_items};
+	// every row head is read once, then one more item per selected item
+	constexpr auto visited{std::min(K + rows, total_items_v<A>)};
+	const instrument_scope<A> instrument{"k_min_sorted_rows", visited, visited * sizeof(item_t)};
+
+	struct head_t {
+		item_t item;
+		std::size_t offset;
+	};
+	// std heap algorithms build max-heaps, so "less" is "comes later".
+	constexpr auto later{[](const head_t& lhs, const head_t& rhs) {
+		return rhs.item < lhs.item || (not (lhs.item < rhs.item) && rhs.offset < lhs.offset);
+	}};
+
+	std::array<head_t, rows> heap{};
+	for (std::size_t r{0}; r < rows; ++r) {
+		heap[r] = {at_offset(a, r * row_items), r * row_items};
+	}
+	std::make_heap(heap.begin(), heap.end(), later);
+
+	std::array<std::size_t, std::min(K, total_items_v<A>)> result{};
+	auto end{heap.end()};
+	for (auto& offset : result) {
+		std::pop_heap(heap.begin(), end, later);
+		auto& head{*(end - 1)};
+		offset = head.offset;
+		if (++head.offset % row_items != 0) {
+			head.item = at_offset(a, head.offset);
+			std::push_heap(heap.begin(), end, later);
+		}
+		else {
+			--end;
+		}
+	}
+	return result;
+}
+
+template <std::size_t K, array A>
+constexpr std::array<runtime_indexer_of_t<A>, std::min(K, total_items_v<A>)> k_min_sorted_rows(const A& a)
+{
+	std::array<runtime_indexer_of_t<A>, std::min(K, total_items_v<A>)> result{};
+	const auto offsets{k_min_sorted_row_offsets<K>(a)};
+	for (std::size_t k{0}; k < offsets.size(); ++k) {
+		result[k] = runtime_indexer_from_offset<extents_of_t<A>>(offsets[k]);
+	}
+	return result;
+}
+
+// compile-time counterpart of k_min_sorted_rows, with the same result type as static_find_k_min.
+template <std::size_t K, typename StaticArray>
+constexpr auto static_k_min_sorted_rows()
+{
+	using array_t = unwrap_static_array_t<StaticArray>;
+	return indexers_from_offsets_t<extents_of_t<array_t>, k_min_sorted_row_offsets<K>(StaticArray::value)>{};
+}
+
+// true if every row and every column of a 2-dim array is sorted ascending (a young tableau).
+template <array A>
+requires (rank_v<A> == 2)
+constexpr bool is_sorted_matrix(const A& a)
+{
+	constexpr auto columns{extent_v<A, 1>};
+	for (std::size_t offset{0}; offset < total_items_v<A>; ++offset) {
+		const auto& item{at_offset(a, offset)};
+		if ((offset % columns != 0 && item < at_offset(a, offset - 1)) || (offset >= columns && item < at_offset(a, offset - columns))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// offsets of the K smallest items of a 2-dim array sorted along both axes, smallest first. the candidates form a frontier that starts at
+// [0][0]: taking an item makes its right neighbour a candidate, and taking the first item of a row also makes the first item of the
+// next row one. at most one candidate per row is pending, so this is O(K log min(K, M)). ties go to the smaller offset, as with
+// k_min_sorted_rows. Checked verifies the precondition first - a compile error in constant evaluation, std::logic_error at runtime.
+template <std::size_t K, bool Checked = false, array A>
+requires (rank_v<A> == 2)
+constexpr std::array<std::size_t, std::min(K, total_items_v<A>)> k_min_sorted_matrix_offsets(const A& a)
+{
+	constexpr auto visited{std::min(2 * K, total_items_v<A>)};
+	const instrument_scope<A> instrument{"k_min_sorted_matrix", visited, visited * sizeof(remove_all_extents_t<A>)};
+	using item_t = remove_all_extents_t<A>;
+	constexpr auto rows{extent_v<A, 0>};
+	constexpr auto columns{extent_v<A, 1>};
+
+	if constexpr (Checked) {
+		if (not is_sorted_matrix(a)) {
+			throw std::logic_error{"k_min_sorted_matrix: rows and columns must be sorted"};
+		}
+	}
+
+	struct candidate_t {
+		item_t item;
+		std::size_t offset;
+	};
+	constexpr auto later{[](const candidate_t& lhs, const candidate_t& rhs) {
+		return rhs.item < lhs.item || (not (lhs.item < rhs.item) && rhs.offset < lhs.offset);
+	}};
+
+	// at most one candidate per row, and at most K - the one spare slot keeps the bound obvious to the compiler as well
+	std::array<candidate_t, std::min(K, rows) + 1> heap{};
+	heap[0] = {at_offset(a, 0), 0};
+	auto end{heap.begin() + 1};
+
+	std::array<std::size_t, std::min(K, total_items_v<A>)> result{};
+	for (std::size_t k{0}; k < result.size(); ++k) {
+		std::pop_heap(heap.begin(), end--, later);
+		const auto taken{end->offset};
+		result[k] = taken;
+		// the last item taken needs no successors - and for K == 1 the heap never grows past one candidate
+		if (k + 1 == result.size()) {
+			break;
+		}
+		if (taken % columns == 0 && taken + columns < total_items_v<A>) {
+			*end++ = {at_offset(a, taken + columns), taken + columns};
+			std::push_heap(heap.begin(), end, later);
+		}
+		if ((taken + 1) % columns != 0) {
+			*end++ = {at_offset(a, taken + 1), taken + 1};
+			std::push_heap(heap.begin(), end, later);
+		}
+	}
+	return result;
+}
+
+template <std::size_t K, bool Checked = false, array A>
+requires (rank_v<A> == 2)
+constexpr std::array<runtime_indexer_of_t<A>, std::min(K, total_items_v<A>)> k_min_sorted_matrix(const A& a)
+{
+	std::array<runtime_indexer_of_t<A>, std::min(K, total_items_v<A>)> result{};
+	const auto offsets{k_min_sorted_matrix_offsets<K, Checked>(a)};
+	for (std::size_t k{0}; k < offsets.size(); ++k) {
+		result[k] = runtime_indexer_from_offset<extents_of_t<A>>(offsets[k]);
+	}
+	return result;
+}
+
+// compile-time counterpart of k_min_sorted_matrix. the precondition is checked by default, since it only costs compile time here.
+template <std::size_t K, typename StaticArray, bool Checked = true>
+constexpr auto static_k_min_sorted_matrix()
+{
+	using array_t = unwrap_static_array_t<StaticArray>;
+	return indexers_from_offsets_t<extents_of_t<array_t>, k_min_sorted_matrix_offsets<K, Checked>(StaticArray::value)>{};
+}
+
+// --- algorithms/sorting -----------------------------------------------------------------------------------------------------------------
+// item types argsort orders by their bits: integers, and ieee floats that fit a 32 or 64-bit key.
+template <typename T>
+concept radix_sortable = std::integral<T>
+	|| (std::floating_point<T> && std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8));
+
+// unsigned key that compares like item does under <. signed integers get their sign bit flipped; negative floats get every bit flipped,
+// the others just the sign bit. -0.0 takes the key of 0.0, so the two stay tied.
+template <radix_sortable T>
+constexpr auto radix_key(T item)
+{
+	if constexpr (std::same_as<T, bool>) {
+		return static_cast<std::uint8_t>(item);
+	}
+	else if constexpr (std::integral<T>) {
+		using key_t = std::make_unsigned_t<T>;
+		constexpr key_t sign{std::is_signed_v<T> ? static_cast<key_t>(key_t{1} << (8 * sizeof(T) - 1)) : key_t{0}};
+		return static_cast<key_t>(static_cast<key_t>(item) ^ sign);
+	}
+	else {
+		using key_t = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+		constexpr key_t sign{key_t{1} << (8 * sizeof(T) - 1)};
+		const auto bits{std::bit_cast<key_t>(item == T{} ? T{} : item)};
+		return static_cast<key_t>((bits & sign) != 0 ? ~bits : bits | sign);
+	}
+}
+
+// 32-bit offsets where they fit, which halves what radix_sort moves around for 32-bit keys.
+template <typename K, std::size_t Total>
+struct keyed_offset {
+	using offset_type = std::conditional_t<Total <= std::numeric_limits<std::uint32_t>::max(), std::uint32_t, std::size_t>;
+
+	K key;
+	offset_type offset;
+};
+
+// stable lsd radix sort of items by key, one byte per pass. all byte counts are taken in a single read of the items up front, and the
+// passes over bytes that every key shares are skipped. scratch must be as large as items.
+template <typename K, std::size_t Total>
+constexpr void radix_sort(std::span<keyed_offset<K, Total>> items, std::span<keyed_offset<K, Total>> scratch)
+{
+	constexpr std::size_t digits{sizeof(K)};
+	std::array<std::array<std::size_t, 256>, digits> counts{};
+	for (const auto& item : items) {
+		for (std::size_t d{0}; d < digits; ++d) {
+			++counts[d][static_cast<std::size_t>(item.key >> (8 * d) & 0xff)];
+		}
+	}
+
+	auto from{items};
+	auto to{scratch};
+	for (std::size_t d{0}; d < digits && not items.empty(); ++d) {
+		auto& positions{counts[d]};
+		if (positions[static_cast<std::size_t>(from[0].key >> (8 * d) & 0xff)] == from.size()) {
+			continue;
+		}
+		std::exclusive_scan(positions.begin(), positions.end(), positions.begin(), std::size_t{0});
+		for (const auto& item : from) {
+			to[positions[static_cast<std::size_t>(item.key >> (8 * d) & 0xff)]++] = item;
+		}
+		std::swap(from, to);
+	}
+	if (from.data() != items.data()) {
+		std::copy(from.begin(), from.end(), items.begin());
+	}
+}
+
+// visits the items of a from offset first up to last, in offset order: f(item, offset, position), where position is where the item's
+// indexer type comes in indexer_list_of_t - the order with axis 0 varying fastest.
+template <array A, typename F>
+constexpr void for_each_list_position(const A& a, std::size_t first, std::size_t last, F f)
+{
+	constexpr auto strides{[] {
+		std::array<std::size_t, rank_v<A>> result{};
+		std::size_t stride{1};
+		for (std::size_t r{0}; r < rank_v<A>; ++r) {
+			result[r] = stride;
+			stride *= extents_array_v<A>[r];
+		}
+		return result;
+	}()};
+	if (first == last) {
+		return;
+	}
+
+	auto item{offset_accessor(a)};
+	auto idx{runtime_indexer_from_offset<extents_of_t<A>>(first).index};
+	std::size_t position{0};
+	for (std::size_t r{0}; r < rank_v<A>; ++r) {
+		position += idx[r] * strides[r];
+	}
+	for (auto offset{first}; offset < last; ++offset) {
+		f(item(offset), offset, position);
+		for (std::size_t r{rank_v<A>}; r-- > 0;) {
+			position += strides[r];
+			if (++idx[r] < extents_array_v<A>[r]) {
+				break;
+			}
+			position -= strides[r] * extents_array_v<A>[r];
+			idx[r] = 0;
+		}
+	}
+}
+
+// offsets of all items of a in ascending order of the items - a permutation of [0, total_items_v<A>). equal items come in
+// indexer_list_of_t order, the order static_find_k_min breaks ties in, so the first K offsets are the ones static_find_k_min<K> picks;
+// runtime_indexers_from_offsets turns them into indexers. radix_sortable items are sorted by radix_key, starting from indexer_list_of_t
+// order, anything else by < with the position in that order breaking ties. with Parallel, large contiguous arrays are split across the
+// outer extent at runtime - the workers place the keys of their rows, sort an equal share each, and the sorted shares are merged
+// pairwise, in parallel too. argsort<false> always stays on the calling thread.
+template <bool Parallel = true, array A>
+constexpr std::vector<std::size_t> argsort(const A& a)
+{
+	const instrument_scope<A> instrument{"argsort", total_items_v<A>,
+		total_items_v<A> * (sizeof(remove_all_extents_t<A>) + sizeof(std::size_t))};
+	using item_t = remove_all_extents_t<A>;
+	std::vector<std::size_t> result(total_items_v<A>);
+
+	if constexpr (radix_sortable<item_t>) {
+		using keyed_t = keyed_offset<decltype(radix_key(item_t{})), total_items_v<A>>;
+		using offset_t = typename keyed_t::offset_type;
+		std::vector<keyed_t> items(total_items_v<A>);
+		std::vector<keyed_t> scratch(total_items_v<A>);
+
+		const auto sorted{[&]() -> const std::vector<keyed_t>& {
+			if !consteval {
+				if constexpr (Parallel && contiguous_array<A>) {
+					constexpr auto row_items{total_items_v<A> / extent_v<A, 0>};
+					if (const auto workers{parallel_workers<A>()}; workers > 1) {
+						parallel_for_outer<A>(workers, [&](std::size_t, std::size_t first, std::size_t last) {
+							for_each_list_position(a, first * row_items, last * row_items,
+								[&items](const item_t& item, std::size_t offset, std::size_t position) {
+									items[position] = {radix_key(item), static_cast<offset_t>(offset)};
+								});
+						});
+						// the shares are ranges of positions, not rows - as many positions as the worker has items
+						std::vector<std::size_t> bounds(workers + 1);
+						for (std::size_t w{0}; w <= workers; ++w) {
+							bounds[w] = extent_v<A, 0> * w / workers * row_items;
+						}
+						parallel_for_outer<A>(workers, [&](std::size_t w, std::size_t, std::size_t) {
+							const auto n{bounds[w + 1] - bounds[w]};
+							radix_sort(std::span<keyed_t>{items}.subspan(bounds[w], n), std::span<keyed_t>{scratch}.subspan(bounds[w], n));
+						});
+
+						// std::merge takes from the first range on ties, so the shares keep their order
+						auto* from{&items};
+						auto* to{&scratch};
+						for (std::size_t width{1}; width < workers; width *= 2) {
+							std::vector<std::jthread> threads{};
+							for (std::size_t w{0}; w < workers; w += 2 * width) {
+								const auto first{bounds[w]};
+								const auto middle{bounds[std::min(w + width, workers)]};
+								const auto last{bounds[std::min(w + 2 * width, workers)]};
+								threads.emplace_back([from, to, first, middle, last] {
+									const auto data{from->data()};
+									std::merge(data + first, data + middle, data + middle, data + last, to->data() + first,
+										[](const keyed_t& lhs, const keyed_t& rhs) { return lhs.key < rhs.key; });
+								});
+							}
+							threads.clear();
+							std::swap(from, to);
+						}
+						return *from;
+					}
+				}
+			}
+
+			for_each_list_position(a, 0, total_items_v<A>, [&items](const item_t& item, std::size_t offset, std::size_t position) {
+				items[position] = {radix_key(item), static_cast<offset_t>(offset)};
+			});
+			radix_sort(std::span<keyed_t>{items}, std::span<keyed_t>{scratch});
+			return items;
+		}()};
+
+		for (std::size_t i{0}; i < result.size(); ++i) {
+			result[i] = sorted[i].offset;
+		}
+	}
+	else {
+		// sorts positions, then maps them back to offsets
+		std::vector<std::size_t> offsets(total_items_v<A>);
+		for_each_list_position(a, 0, total_items_v<A>, [&offsets](const item_t&, std::size_t offset, std::size_t position) {
+			offsets[position] = offset;
+		});
+		std::iota(result.begin(), result.end(), std::size_t{0});
+		auto item{offset_accessor(a)};
+		std::sort(result.begin(), result.end(), [&item, &offsets](std::size_t lhs, std::size_t rhs) {
+			return item(offsets[lhs]) < item(offsets[rhs]) || (not (item(offsets[rhs]) < item(offsets[lhs])) && lhs < rhs);
+		});
+		for (auto& position : result) {
+			position = offsets[position];
+		}
+	}
+	return result;
+}
+
+// --- algorithms/stencils ----------------------------------------------------------------------------------------------------------------
+// what a stencil reads for neighbours outside the array.
+enum class boundary {
+	clamp,// the nearest item on the edge
+	wrap,// the item on the opposite side (periodic)
+	zero,// nothing - the tap is left out
+	skip,// only items with their whole neighbourhood inside are computed, so the result is smaller by the kernel extent - 1 on each axis
+};
+
+template <array A, array Kernel, boundary B, std::size_t...Is>
+requires (B != boundary::skip || ((extent_v<Kernel, Is> <= extent_v<A, Is>) && ...))
+constexpr auto stencil_extents(const std::index_sequence<Is...>&)
+{
+	if constexpr (B == boundary::skip) {
+		return std::index_sequence<extent_v<A, Is> - extent_v<Kernel, Is> + 1 ...>{};
+	}
+	else {
+		return extents_of_t<A>{};
+	}
+}
+
+// extents of the result of stencil<B>(a, kernel, result).
+template <array A, array Kernel, boundary B>
+requires (rank_v<A> == rank_v<Kernel>)
+using stencil_extents_t = decltype(stencil_extents<A, Kernel, B>(std::make_index_sequence<rank_v<A>>{}));
+
+template <array A, array Kernel, boundary B, typename T = decltype(remove_all_extents_t<A>{} * remove_all_extents_t<Kernel>{})>
+using stencil_result_t = std_array_of_t<T, stencil_extents_t<A, Kernel, B>>;
+
+// result[i][j] = sum of kernel[di][dj] * a[i + di - ri][j + dj - rj] over the kernel (ri, rj: its radii), and the same for rank 3. the
+// kernel's extents have to be odd. rows whose neighbourhood is inside the array are computed one tap at a time over the whole inner
+// stretch of the row, which is branch-free and vectorizes - only the cells within a radius of an edge go through B.
+template <boundary B = boundary::clamp, array A, array Kernel, array Result>
+requires ((rank_v<A> == 2 || rank_v<A> == 3) && rank_v<Kernel> == rank_v<A>
+	&& std::is_same_v<extents_of_t<Result>, stencil_extents_t<A, Kernel, B>>)
+constexpr void stencil(const A& a, const Kernel& kernel, Result& result)
+{
+	const instrument_scope<A> instrument{"stencil", total_items_v<A>,
+		(total_items_v<A> + total_items_v<Result>) * sizeof(remove_all_extents_t<A>)};
+	constexpr auto R{rank_v<A>};
+	constexpr auto taps{total_items_v<Kernel>};
+	using result_t = remove_all_extents_t<Result>;
+	using signed_t = std::ptrdiff_t;
+
+	constexpr auto to_array{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+		return std::array<std::size_t, sizeof...(Es)>{Es...};
+	}};
+	constexpr auto extents{to_array(extents_of_t<A>{})};
+	constexpr auto kernel_extents{to_array(extents_of_t<Kernel>{})};
+	constexpr auto result_extents{to_array(extents_of_t<Result>{})};
+	static_assert(std::ranges::all_of(kernel_extents, [](std::size_t e) { return e % 2 == 1; }), "kernel extents have to be odd");
+
+	// per axis: row-major stride of a, radius of the kernel, and how far a result index is from the index of its centre item in a
+	std::array<std::size_t, R> strides{};
+	std::array<std::size_t, R> radius{};
+	std::array<std::size_t, R> shift{};
+	strides.back() = 1;
+	for (std::size_t r{R - 1}; r-- > 0;) {
+		strides[r] = strides[r + 1] * extents[r + 1];
+	}
+	for (std::size_t r{0}; r < R; ++r) {
+		radius[r] = kernel_extents[r] / 2;
+		shift[r] = B == boundary::skip ? radius[r] : 0;
+	}
+
+	// per tap: position relative to the centre, and the offset that makes in a
+	std::array<std::array<signed_t, R>, taps> tap_index{};
+	std::array<signed_t, taps> tap_offset{};
+	for (std::size_t t{0}; t < taps; ++t) {
+		const auto idx{runtime_indexer_from_offset<extents_of_t<Kernel>>(t)};
+		for (std::size_t r{0}; r < R; ++r) {
+			tap_index[t][r] = static_cast<signed_t>(idx.index[r]) - static_cast<signed_t>(radius[r]);
+			tap_offset[t] += tap_index[t][r] * static_cast<signed_t>(strides[r]);
+		}
+	}
+
+	auto item{offset_accessor(a)};
+	auto weight{offset_accessor(kernel)};
+	auto result_item{offset_accessor(result)};
+
+	const auto edge_cell{[&](const std::array<std::size_t, R>& centre) {
+		result_t sum{};
+		for (std::size_t t{0}; t < taps; ++t) {
+			std::size_t offset{0};
+			bool inside{true};
+			for (std::size_t r{0}; r < R; ++r) {
+				const auto e{static_cast<signed_t>(extents[r])};
+				auto i{static_cast<signed_t>(centre[r]) + tap_index[t][r]};
+				if constexpr (B == boundary::clamp) {
+					i = std::clamp(i, signed_t{0}, e - 1);
+				}
+				else if constexpr (B == boundary::wrap) {
+					i = (i % e + e) % e;
+				}
+				else {
+					inside = inside && i >= 0 && i < e;
+				}
+				offset += static_cast<std::size_t>(i) * strides[r];
+			}
+			if (inside) {
+				sum += static_cast<result_t>(weight(t) * item(offset));
+			}
+		}
+		return sum;
+	}};
+
+	// the stretch [first, last) of result rows whose centres have their whole neighbourhood inside a.
+	constexpr auto row_items{result_extents.back()};
+	const auto first{std::min(radius.back() - shift.back(), row_items)};
+	const auto last{std::max(first, std::min(row_items, extents.back() - std::min(extents.back(), radius.back() + shift.back())))};
+
+	std::array<std::size_t, R> lead{};
+	std::array<std::size_t, R> lead_last{result_extents};
+	std::array<std::size_t, R> lead_step{};
+	lead_last.back() = 1;
+	lead_step.fill(1);
+	do {
+		std::array<std::size_t, R> centre{};
+		bool interior{true};
+		std::size_t result_offset{0};
+		std::size_t centre_offset{0};
+		for (std::size_t r{0}; r + 1 < R; ++r) {
+			centre[r] = lead[r] + shift[r];
+			interior = interior && centre[r] >= radius[r] && centre[r] + radius[r] < extents[r];
+			result_offset = (result_offset + lead[r]) * result_extents[r + 1];
+			centre_offset += centre[r] * strides[r];
+		}
+		centre_offset += shift.back();
+
+		const auto edge_stretch{[&](std::size_t from, std::size_t to) {
+			for (std::size_t j{from}; j < to; ++j) {
+				centre.back() = j + shift.back();
+				result_item(result_offset + j) = edge_cell(centre);
+			}
+		}};
+
+		if (interior) {
+			edge_stretch(0, first);
+			for (std::size_t j{first}; j < last; ++j) {
+				result_item(result_offset + j) = result_t{};
+			}
+			for (std::size_t t{0}; t < taps; ++t) {
+				const auto w{weight(t)};
+				const auto tap{centre_offset + static_cast<std::size_t>(tap_offset[t])};
+				for (std::size_t j{first}; j < last; ++j) {
+					result_item(result_offset + j) += static_cast<result_t>(w * item(tap + j));
+				}
+			}
+			edge_stretch(last, row_items);
+		}
+		else {
+			edge_stretch(0, row_items);
+		}
+	} while (next_index(lead, {}, lead_last, lead_step));
+}
+
+// --- algorithms/counting -----------------------------------------------------------------------------------------------------------------
+template <typename T, typename Pred>
+constexpr std::size_t count_if(std::span<T> run, Pred& pred)
+{
+	constexpr auto lanes{simd_lanes_v<std::remove_cv_t<T>>};
+	std::array<std::size_t, lanes> counts{};
+	const auto blocks{run.first(run.size() / lanes * lanes)};
+	const auto tail{run.last(run.size() % lanes)};
+
+	for (std::size_t i{0}; i < blocks.size(); i += lanes) {
+		for (std::size_t l{0}; l < lanes; ++l) {
+			counts[l] += pred(blocks[i + l]) ? 1u : 0u;
+		}
+	}
+	for (std::size_t l{0}; l < tail.size(); ++l) {
+		counts[l] += pred(tail[l]) ? 1u : 0u;
+	}
+
+	std::size_t count{0};
+	for (const auto c : counts) {
+		count += c;
+	}
+	return count;
+}
+
+template <array A, typename Pred>
+constexpr std::size_t count_if(const A& a, Pred pred)
+{
+	const instrument_scope<A> instrument{"count_if"};
+	if !consteval {
+		if constexpr (contiguous_array<A>) {
+			constexpr auto row_items{total_items_v<A> / extent_v<A, 0>};
+			if (const auto workers{parallel_workers<A>()}; workers > 1) {
+				std::vector<std::size_t> counts(workers);
+				parallel_for_outer<A>(workers, [&](std::size_t w, std::size_t first, std::size_t last) {
+					counts[w] = count_if(std::span{flat_data(a) + first * row_items, (last - first) * row_items}, pred);
+				});
+				std::size_t count{0};
+				for (const auto c : counts) {
+					count += c;
+				}
+				return count;
+			}
+		}
+	}
+
+	constexpr auto lanes{simd_lanes_v<remove_all_extents_t<A>>};
+	std::array<std::size_t, lanes> counts{};
+	for_each_block<lanes>(a, [&](auto block, std::size_t, auto valid) {
+		for (std::size_t l{0}; l < lanes; ++l) {
+			counts[l] += l < valid && pred(block[l]) ? 1u : 0u;
+		}
+	});
+
+	std::size_t count{0};
+	for (const auto c : counts) {
+		count += c;
+	}
+	return count;
+}
+
+template <typename T, std::size_t B>
+constexpr std::size_t histogram_bin(const T& item, const std::array<T, B + 1>& bins)
+{
+	if (item < bins[0] || not (item < bins[B])) {
+		return B;
+	}
+	return static_cast<std::size_t>(std::upper_bound(bins.begin(), bins.end(), item) - bins.begin()) - 1;
+}
+
+// items of 1-byte integral types are counted straight into tables indexed by their value, which are folded into the bins at the end.
+// bools have no unsigned counterpart to index with, and only two values anyway.
+template <typename T>
+concept small_integral = std::integral<T> && not std::same_as<T, bool> && sizeof(T) == 1;
+
+// consecutive items go to different value tables, so runs of equal values don't serialize on a single counter.
+inline constexpr std::size_t histogram_sub_tables{4};
+
+template <small_integral T>
+using histogram_tables_t = std::array<std::array<std::size_t, std::size_t{1} << (8 * sizeof(T))>, histogram_sub_tables>;
+
+template <typename T>
+requires small_integral<std::remove_cv_t<T>>
+constexpr void histogram(std::span<T> run, histogram_tables_t<std::remove_cv_t<T>>& tables)
+{
+	using unsigned_t = std::make_unsigned_t<std::remove_cv_t<T>>;
+
+	std::size_t i{0};
+	for (; i + histogram_sub_tables <= run.size(); i += histogram_sub_tables) {
+		for (std::size_t t{0}; t < histogram_sub_tables; ++t) {
+			++tables[t][static_cast<unsigned_t>(run[i + t])];
+		}
+	}
+	for (; i < run.size(); ++i) {
+		++tables[0][static_cast<unsigned_t>(run[i])];
+	}
+}
+
+template <small_integral T, std::size_t B>
+constexpr void histogram(const histogram_tables_t<T>& tables, const std::array<T, B + 1>& bins, std::array<std::size_t, B>& counts)
+{
+	using unsigned_t = std::make_unsigned_t<T>;
+
+	for (std::size_t v{0}; v < tables[0].size(); ++v) {
+		if (const auto bin{histogram_bin<T, B>(static_cast<T>(static_cast<unsigned_t>(v)), bins)}; bin < B) {
+			for (const auto& table : tables) {
+				counts[bin] += table[v];
+			}
+		}
+	}
+}
+
+template <typename T, std::size_t B>
+constexpr void histogram(std::span<T> run, const std::array<std::remove_cv_t<T>, B + 1>& bins, std::array<std::size_t, B>& counts)
+{
+	if constexpr (small_integral<std::remove_cv_t<T>>) {
+		histogram_tables_t<std::remove_cv_t<T>> tables{};
+		histogram(run, tables);
+		histogram<std::remove_cv_t<T>, B>(tables, bins, counts);
+	}
+	else {
+		for (const auto& item : run) {
+			if (const auto bin{histogram_bin<std::remove_cv_t<T>, B>(item, bins)}; bin < B) {
+				++counts[bin];
+			}
+		}
+	}
+}
+
+// counts the items falling in each of the B half-open bins [bins[i], bins[i + 1]). bins must be ascending. items outside of
+// [bins[0], bins[B]) aren't counted.
+template <array A, std::size_t N>
+requires (N > 1)
+constexpr std::array<std::size_t, N - 1> histogram(const A& a, const std::array<remove_all_extents_t<A>, N>& bins)
+{
+	const instrument_scope<A> instrument{"histogram"};
+	using item_t = remove_all_extents_t<A>;
+	constexpr auto B{N - 1};
+
+	if !consteval {
+		if constexpr (contiguous_array<A>) {
+			constexpr auto row_items{total_items_v<A> / extent_v<A, 0>};
+			if (const auto workers{parallel_workers<A>()}; workers > 1) {
+				std::vector<std::array<std::size_t, B>> partial(workers);
+				parallel_for_outer<A>(workers, [&](std::size_t w, std::size_t first, std::size_t last) {
+					histogram<const item_t, B>(std::span{flat_data(a) + first * row_items, (last - first) * row_items}, bins, partial[w]);
+				});
+				std::array<std::size_t, B> counts{};
+				for (const auto& p : partial) {
+					for (std::size_t b{0}; b < B; ++b) {
+						counts[b] += p[b];
+					}
+				}
+				return counts;
+			}
+		}
+	}
+
+	std::array<std::size_t, B> counts{};
+	if constexpr (small_integral<item_t>) {
+		using unsigned_t = std::make_unsigned_t<item_t>;
+		histogram_tables_t<item_t> tables{};
+		for_each_block<histogram_sub_tables>(a, [&](auto block, std::size_t, auto valid) {
+			for (std::size_t t{0}; t < histogram_sub_tables; ++t) {
+				tables[t][static_cast<unsigned_t>(block[t])] += t < valid ? 1u : 0u;
+			}
+		});
+		histogram<item_t, B>(tables, bins, counts);
+	}
+	else {
+		constexpr auto lanes{simd_lanes_v<item_t>};
+		for_each_block<lanes>(a, [&](auto block, std::size_t, auto valid) {
+			for (std::size_t l{0}; l < lanes; ++l) {
+				if (const auto bin{histogram_bin<item_t, B>(block[l], bins)}; l < valid && bin < B) {
+					++counts[bin];
+				}
+			}
+		});
+	}
+	return counts;
+}
+
+// --- algorithms/scans --------------------------------------------------------------------------------------------------------------------
+// item type of a scan with op: whatever op returns for two items, so std::plus<> promotes narrow items like sum(a) does.
+template <array A, typename BinOp>
+using scan_result_t = std::remove_cvref_t<std::invoke_result_t<BinOp&, const remove_all_extents_t<A>&, const remove_all_extents_t<A>&>>;
+
+template <array A, typename T = remove_all_extents_t<A>>
+constexpr auto copy_to_std_array(const A& a)
+{
+	std_array_of_t<T, extents_of_t<A>> result{};
+	auto item{offset_accessor(result)};
+
+	for_each_run(a, [&](auto run, std::size_t offset) {
+		for (std::size_t i{0}; i < run.size(); ++i) {
+			item(offset + i) = static_cast<T>(run[i]);
+		}
+	});
+	return result;
+}
+
+// in-place inclusive scan along each run of N consecutive items - Hillis-Steele scan inside blocks of simd_lanes_v<T> items, with the
+// carry of the previous block folded in afterwards.
+template <typename T, std::size_t Outer, std::size_t N, typename Item, typename BinOp>
+constexpr void inclusive_scan_inner(Item item, BinOp op)
+{
+	constexpr auto lanes{simd_lanes_v<T>};
+
+	for (std::size_t o{0}; o < Outer; ++o) {
+		const auto row{o * N};
+		std::size_t n{0};
+
+		if constexpr (lanes > 1) {
+			for (; n + lanes <= N; n += lanes) {
+				std::array<T, lanes> x{};
+				for (std::size_t l{0}; l < lanes; ++l) {
+					x[l] = item(row + n + l);
+				}
+				for (std::size_t shift{1}; shift < lanes; shift *= 2) {
+					for (std::size_t l{lanes}; l-- > shift;) {
+						x[l] = op(x[l - shift], x[l]);
+					}
+				}
+				if (n > 0) {
+					const T carry{item(row + n - 1)};
+					for (std::size_t l{0}; l < lanes; ++l) {
+						x[l] = op(carry, x[l]);
+					}
+				}
+				for (std::size_t l{0}; l < lanes; ++l) {
+					item(row + n + l) = x[l];
+				}
+			}
+		}
+		for (n = std::max(n, std::size_t{1}); n < N; ++n) {
+			item(row + n) = op(item(row + n - 1), item(row + n));
+		}
+	}
+}
+
+// in-place inclusive scan along an outer axis - each row of Inner items is combined with the previous row in one vectorizable sweep.
+template <std::size_t Outer, std::size_t N, std::size_t Inner, typename Item, typename BinOp>
+constexpr void inclusive_scan_outer(Item item, BinOp op)
+{
+	for (std::size_t o{0}; o < Outer; ++o) {
+		for (std::size_t n{1}; n < N; ++n) {
+			const auto row{(o * N + n) * Inner};
+			for (std::size_t i{0}; i < Inner; ++i) {
+				item(row + i) = op(item(row - Inner + i), item(row + i));
+			}
+		}
+	}
+}
+
+template <std::size_t Axis, array A, typename T, typename Item, typename BinOp>
+constexpr void inclusive_scan_axis(Item item, BinOp op)
+{
+	constexpr auto outer{outer_items_v<A, Axis>};
+	constexpr auto n{extent_v<A, Axis>};
+	constexpr auto inner{inner_items_v<A, Axis>};
+
+	if constexpr (inner == 1) {
+		inclusive_scan_inner<T, outer, n>(item, op);
+	}
+	else {
+		inclusive_scan_outer<outer, n, inner>(item, op);
+	}
+}
+
+// the work of inclusive_scan, unreported - exclusive_scan runs it too and reports once for the whole call.
+template <std::size_t Axis, array A, typename BinOp>
+constexpr auto inclusive_scan_copy(const A& a, BinOp op)
+{
+	using scan_t = scan_result_t<A, BinOp>;
+	auto result{copy_to_std_array<A, scan_t>(a)};
+	inclusive_scan_axis<Axis, A, scan_t>(offset_accessor(result), op);
+	return result;
+}
+
+// running op(...) of the items along Axis: result[..., i, ...] == op(a[..., 0, ...], ..., a[..., i, ...]). op must be associative.
+// the result is a std::array (nested to rank_v<A>) with the extents of a and items of scan_result_t<A, BinOp> - a prefix sum of
+// uint8_t items is an int array, so it doesn't wrap at 255. the running values still overflow if they don't fit in that type.
+template <std::size_t Axis, array A, typename BinOp = std::plus<>>
+requires (Axis < rank_v<A>)
+constexpr auto inclusive_scan(const A& a, BinOp op = {})
+{
+	const instrument_scope<A> instrument{"inclusive_scan", total_items_v<A>,
+		total_items_v<A> * (sizeof(remove_all_extents_t<A>) + sizeof(scan_result_t<A, BinOp>))};
+	return inclusive_scan_copy<Axis>(a, op);
+}
+
+// like inclusive_scan, but shifted by one item along Axis and seeded with init:
+// result[..., 0, ...] == init, result[..., i, ...] == op(init, a[..., 0, ...], ..., a[..., i - 1, ...]).
+template <std::size_t Axis, array A, typename BinOp = std::plus<>>
+requires (Axis < rank_v<A>)
+constexpr auto exclusive_scan(const A& a, scan_result_t<A, BinOp> init = {}, BinOp op = {})
+{
+	const instrument_scope<A> instrument{"exclusive_scan", total_items_v<A>,
+		total_items_v<A> * (sizeof(remove_all_extents_t<A>) + sizeof(scan_result_t<A, BinOp>))};
+	constexpr auto outer{outer_items_v<A, Axis>};
+	constexpr auto n{extent_v<A, Axis>};
+	constexpr auto inner{inner_items_v<A, Axis>};
+
+	auto result{inclusive_scan_copy<Axis>(a, op)};
+	auto item{offset_accessor(result)};
+
+	for (std::size_t o{0}; o < outer; ++o) {
+		for (std::size_t i{n}; i-- > 1;) {
+			const auto row{(o * n + i) * inner};
+			for (std::size_t j{0}; j < inner; ++j) {
+				item(row + j) = op(init, item(row - inner + j));
+			}
+		}
+		for (std::size_t j{0}; j < inner; ++j) {
+			item(o * n * inner + j) = init;
+		}
+	}
+	return result;
+}
+
 }//metarray
@@ -0,0 +1,423 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// reference implementation of the c++23 <mdspan> interface (extents, layout_right, layout_left, layout_stride, default_accessor and
+// mdspan) for standard libraries that don't ship <mdspan> yet. metarray.hpp only pulls it in when __cpp_lib_mdspan is not defined, and
+// refers to whichever one is in use through the stdex namespace alias. submdspan and the deduction guides are not provided.
+namespace metarray::mdspan_ref {
+
+// --- extents -----------------------------------------------------------------------------------------------------------------------------
+template <typename IndexType, std::size_t...Extents>
+requires std::integral<IndexType>
+class extents {
+public:
+	using index_type = IndexType;
+	using size_type = std::make_unsigned_t<index_type>;
+	using rank_type = std::size_t;
+
+	static constexpr rank_type rank() noexcept { return sizeof...(Extents); }
+	static constexpr rank_type rank_dynamic() noexcept { return ((Extents == std::dynamic_extent ? rank_type{1} : rank_type{0}) + ... + rank_type{0}); }
+
+	static constexpr std::size_t static_extent(rank_type r) noexcept
+	{
+		constexpr std::array<std::size_t, rank()> static_extents{Extents...};
+		return static_extents[r];
+	}
+
+	constexpr index_type extent(rank_type r) const noexcept
+	{
+		if (static_extent(r) == std::dynamic_extent) {
+			return dynamic_[dynamic_index(r)];
+		}
+		return static_cast<index_type>(static_extent(r));
+	}
+
+	constexpr extents() noexcept = default;
+
+	// either only the dynamic extents, or all of them - in which case the static ones have to match.
+	template <typename...OtherIndexTypes>
+	requires ((std::is_convertible_v<OtherIndexTypes, index_type> && ...)
+		&& (sizeof...(OtherIndexTypes) == rank_dynamic() || sizeof...(OtherIndexTypes) == rank()))
+	constexpr explicit extents(OtherIndexTypes...exts) noexcept
+		: extents(std::array<index_type, sizeof...(OtherIndexTypes)>{static_cast<index_type>(exts)...})
+	{}
+
+	template <typename OtherIndexType, std::size_t N>
+	requires (std::is_convertible_v<const OtherIndexType&, index_type> && (N == rank_dynamic() || N == rank()))
+	constexpr explicit(N != rank_dynamic()) extents(const std::array<OtherIndexType, N>& exts) noexcept
+	{
+		if constexpr (N == rank_dynamic()) {
+			for (rank_type d{0}; d < N; ++d) {
+				dynamic_[d] = static_cast<index_type>(exts[d]);
+			}
+		}
+		else {
+			for (rank_type r{0}; r < N; ++r) {
+				if (static_extent(r) == std::dynamic_extent) {
+					dynamic_[dynamic_index(r)] = static_cast<index_type>(exts[r]);
+				}
+			}
+		}
+	}
+
+	template <typename OtherIndexType, std::size_t...OtherExtents>
+	requires (sizeof...(OtherExtents) == rank()
+		&& ((OtherExtents == std::dynamic_extent || Extents == std::dynamic_extent || OtherExtents == Extents) && ...))
+	constexpr explicit(((Extents != std::dynamic_extent && OtherExtents == std::dynamic_extent) || ...))
+	extents(const extents<OtherIndexType, OtherExtents...>& other) noexcept
+	{
+		for (rank_type r{0}; r < rank(); ++r) {
+			if (static_extent(r) == std::dynamic_extent) {
+				dynamic_[dynamic_index(r)] = static_cast<index_type>(other.extent(r));
+			}
+		}
+	}
+
+	template <typename OtherIndexType, std::size_t...OtherExtents>
+	friend constexpr bool operator==(const extents& lhs, const extents<OtherIndexType, OtherExtents...>& rhs) noexcept
+	{
+		if constexpr (rank() != sizeof...(OtherExtents)) {
+			return false;
+		}
+		else {
+			for (rank_type r{0}; r < rank(); ++r) {
+				if (static_cast<std::size_t>(lhs.extent(r)) != static_cast<std::size_t>(rhs.extent(r))) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+private:
+	static constexpr rank_type dynamic_index(rank_type r) noexcept
+	{
+		rank_type index{0};
+		for (rank_type i{0}; i < r; ++i) {
+			index += static_extent(i) == std::dynamic_extent ? rank_type{1} : rank_type{0};
+		}
+		return index;
+	}
+
+	std::array<index_type, rank_dynamic()> dynamic_{};
+};
+
+template <std::size_t>
+inline constexpr auto dynamic_extent_v{std::dynamic_extent};
+
+template <typename IndexType, std::size_t Rank, typename = std::make_index_sequence<Rank>>
+struct dextents_of;
+
+template <typename IndexType, std::size_t Rank, std::size_t...Is>
+struct dextents_of<IndexType, Rank, std::index_sequence<Is...>> {
+	using type = extents<IndexType, dynamic_extent_v<Is>...>;
+};
+
+template <typename IndexType, std::size_t Rank>
+using dextents = dextents_of<IndexType, Rank>::type;
+
+template <typename Extents>
+constexpr typename Extents::index_type extents_product(const Extents& e, std::size_t first, std::size_t last) noexcept
+{
+	typename Extents::index_type product{1};
+	for (std::size_t r{first}; r < last; ++r) {
+		product *= e.extent(r);
+	}
+	return product;
+}
+
+// --- layouts -----------------------------------------------------------------------------------------------------------------------------
+// row-major: the last index is the fastest moving one.
+struct layout_right {
+	template <typename Extents>
+	class mapping;
+};
+
+// column-major: the first index is the fastest moving one.
+struct layout_left {
+	template <typename Extents>
+	class mapping;
+};
+
+// an explicit stride per extent.
+struct layout_stride {
+	template <typename Extents>
+	class mapping;
+};
+
+template <typename Extents>
+class layout_right::mapping {
+public:
+	using extents_type = Extents;
+	using index_type = extents_type::index_type;
+	using size_type = extents_type::size_type;
+	using rank_type = extents_type::rank_type;
+	using layout_type = layout_right;
+
+	constexpr mapping() noexcept = default;
+	constexpr mapping(const extents_type& e) noexcept : extents_{e} {}
+
+	constexpr const extents_type& extents() const noexcept { return extents_; }
+	constexpr index_type required_span_size() const noexcept { return extents_product(extents_, 0, extents_type::rank()); }
+
+	template <typename...Indices>
+	requires (sizeof...(Indices) == extents_type::rank() && (std::is_convertible_v<Indices, index_type> && ...))
+	constexpr index_type operator()(Indices...indices) const noexcept
+	{
+		const std::array<index_type, extents_type::rank()> idx{static_cast<index_type>(indices)...};
+		index_type offset{0};
+		for (rank_type r{0}; r < extents_type::rank(); ++r) {
+			offset = offset * extents_.extent(r) + idx[r];
+		}
+		return offset;
+	}
+
+	static constexpr bool is_always_unique() noexcept { return true; }
+	static constexpr bool is_always_exhaustive() noexcept { return true; }
+	static constexpr bool is_always_strided() noexcept { return true; }
+	static constexpr bool is_unique() noexcept { return true; }
+	static constexpr bool is_exhaustive() noexcept { return true; }
+	static constexpr bool is_strided() noexcept { return true; }
+
+	constexpr index_type stride(rank_type r) const noexcept
+	requires (extents_type::rank() > 0)
+	{
+		return extents_product(extents_, r + 1, extents_type::rank());
+	}
+
+	friend constexpr bool operator==(const mapping& lhs, const mapping& rhs) noexcept { return lhs.extents_ == rhs.extents_; }
+
+private:
+	extents_type extents_{};
+};
+
+template <typename Extents>
+class layout_left::mapping {
+public:
+	using extents_type = Extents;
+	using index_type = extents_type::index_type;
+	using size_type = extents_type::size_type;
+	using rank_type = extents_type::rank_type;
+	using layout_type = layout_left;
+
+	constexpr mapping() noexcept = default;
+	constexpr mapping(const extents_type& e) noexcept : extents_{e} {}
+
+	constexpr const extents_type& extents() const noexcept { return extents_; }
+	constexpr index_type required_span_size() const noexcept { return extents_product(extents_, 0, extents_type::rank()); }
+
+	template <typename...Indices>
+	requires (sizeof...(Indices) == extents_type::rank() && (std::is_convertible_v<Indices, index_type> && ...))
+	constexpr index_type operator()(Indices...indices) const noexcept
+	{
+		const std::array<index_type, extents_type::rank()> idx{static_cast<index_type>(indices)...};
+		index_type offset{0};
+		for (rank_type r{extents_type::rank()}; r-- > 0;) {
+			offset = offset * extents_.extent(r) + idx[r];
+		}
+		return offset;
+	}
+
+	static constexpr bool is_always_unique() noexcept { return true; }
+	static constexpr bool is_always_exhaustive() noexcept { return true; }
+	static constexpr bool is_always_strided() noexcept { return true; }
+	static constexpr bool is_unique() noexcept { return true; }
+	static constexpr bool is_exhaustive() noexcept { return true; }
+	static constexpr bool is_strided() noexcept { return true; }
+
+	constexpr index_type stride(rank_type r) const noexcept
+	requires (extents_type::rank() > 0)
+	{
+		return extents_product(extents_, 0, r);
+	}
+
+	friend constexpr bool operator==(const mapping& lhs, const mapping& rhs) noexcept { return lhs.extents_ == rhs.extents_; }
+
+private:
+	extents_type extents_{};
+};
+
+template <typename Extents>
+class layout_stride::mapping {
+public:
+	using extents_type = Extents;
+	using index_type = extents_type::index_type;
+	using size_type = extents_type::size_type;
+	using rank_type = extents_type::rank_type;
+	using layout_type = layout_stride;
+
+	// row-major strides, like layout_right.
+	constexpr mapping() noexcept
+	{
+		for (rank_type r{0}; r < extents_type::rank(); ++r) {
+			strides_[r] = extents_product(extents_, r + 1, extents_type::rank());
+		}
+	}
+
+	template <typename OtherIndexType>
+	requires std::is_convertible_v<const OtherIndexType&, index_type>
+	constexpr mapping(const extents_type& e, std::span<OtherIndexType, extents_type::rank()> s) noexcept : extents_{e}
+	{
+		for (rank_type r{0}; r < extents_type::rank(); ++r) {
+			strides_[r] = static_cast<index_type>(s[r]);
+		}
+	}
+
+	template <typename OtherIndexType>
+	requires std::is_convertible_v<const OtherIndexType&, index_type>
+	constexpr mapping(const extents_type& e, const std::array<OtherIndexType, extents_type::rank()>& s) noexcept
+		: mapping(e, std::span{s})
+	{}
+
+	constexpr const extents_type& extents() const noexcept { return extents_; }
+	constexpr std::array<index_type, extents_type::rank()> strides() const noexcept { return strides_; }
+
+	constexpr index_type required_span_size() const noexcept
+	{
+		index_type size{1};
+		for (rank_type r{0}; r < extents_type::rank(); ++r) {
+			if (extents_.extent(r) == 0) {
+				return 0;
+			}
+			size += (extents_.extent(r) - 1) * strides_[r];
+		}
+		return size;
+	}
+
+	template <typename...Indices>
+	requires (sizeof...(Indices) == extents_type::rank() && (std::is_convertible_v<Indices, index_type> && ...))
+	constexpr index_type operator()(Indices...indices) const noexcept
+	{
+		const std::array<index_type, extents_type::rank()> idx{static_cast<index_type>(indices)...};
+		index_type offset{0};
+		for (rank_type r{0}; r < extents_type::rank(); ++r) {
+			offset += idx[r] * strides_[r];
+		}
+		return offset;
+	}
+
+	static constexpr bool is_always_unique() noexcept { return true; }
+	static constexpr bool is_always_exhaustive() noexcept { return false; }
+	static constexpr bool is_always_strided() noexcept { return true; }
+	static constexpr bool is_unique() noexcept { return true; }
+	constexpr bool is_exhaustive() const noexcept { return required_span_size() == extents_product(extents_, 0, extents_type::rank()); }
+	static constexpr bool is_strided() noexcept { return true; }
+
+	constexpr index_type stride(rank_type r) const noexcept { return strides_[r]; }
+
+	friend constexpr bool operator==(const mapping& lhs, const mapping& rhs) noexcept
+	{
+		return lhs.extents_ == rhs.extents_ && lhs.strides_ == rhs.strides_;
+	}
+
+private:
+	extents_type extents_{};
+	std::array<index_type, extents_type::rank()> strides_{};
+};
+
+// --- accessors ---------------------------------------------------------------------------------------------------------------------------
+template <typename ElementType>
+struct default_accessor {
+	using offset_policy = default_accessor;
+	using element_type = ElementType;
+	using reference = ElementType&;
+	using data_handle_type = ElementType*;
+
+	constexpr default_accessor() noexcept = default;
+
+	template <typename OtherElementType>
+	requires std::is_convertible_v<OtherElementType(*)[], element_type(*)[]>
+	constexpr default_accessor(default_accessor<OtherElementType>) noexcept {}
+
+	constexpr reference access(data_handle_type p, std::size_t i) const noexcept { return p[i]; }
+	constexpr data_handle_type offset(data_handle_type p, std::size_t i) const noexcept { return p + i; }
+};
+
+// --- mdspan ------------------------------------------------------------------------------------------------------------------------------
+template <typename ElementType, typename Extents, typename LayoutPolicy = layout_right,
+	typename AccessorPolicy = default_accessor<ElementType>>
+class mdspan {
+public:
+	using extents_type = Extents;
+	using layout_type = LayoutPolicy;
+	using accessor_type = AccessorPolicy;
+	using mapping_type = typename layout_type::template mapping<extents_type>;
+	using element_type = ElementType;
+	using value_type = std::remove_cv_t<element_type>;
+	using index_type = extents_type::index_type;
+	using size_type = extents_type::size_type;
+	using rank_type = extents_type::rank_type;
+	using data_handle_type = accessor_type::data_handle_type;
+	using reference = accessor_type::reference;
+
+	static constexpr rank_type rank() noexcept { return extents_type::rank(); }
+	static constexpr rank_type rank_dynamic() noexcept { return extents_type::rank_dynamic(); }
+	static constexpr std::size_t static_extent(rank_type r) noexcept { return extents_type::static_extent(r); }
+	constexpr index_type extent(rank_type r) const noexcept { return extents().extent(r); }
+
+	constexpr mdspan()
+	requires (rank_dynamic() > 0)
+	= default;
+
+	template <typename...OtherIndexTypes>
+	requires ((std::is_convertible_v<OtherIndexTypes, index_type> && ...)
+		&& (sizeof...(OtherIndexTypes) == rank() || sizeof...(OtherIndexTypes) == rank_dynamic()))
+	constexpr explicit mdspan(data_handle_type p, OtherIndexTypes...exts)
+		: ptr_{std::move(p)}, map_{extents_type{static_cast<index_type>(exts)...}}, acc_{}
+	{}
+
+	template <typename OtherIndexType, std::size_t N>
+	requires (std::is_convertible_v<const OtherIndexType&, index_type> && (N == rank() || N == rank_dynamic()))
+	constexpr explicit(N != rank_dynamic()) mdspan(data_handle_type p, const std::array<OtherIndexType, N>& exts)
+		: ptr_{std::move(p)}, map_{extents_type{exts}}, acc_{}
+	{}
+
+	constexpr mdspan(data_handle_type p, const extents_type& ext) : ptr_{std::move(p)}, map_{ext}, acc_{} {}
+	constexpr mdspan(data_handle_type p, const mapping_type& m) : ptr_{std::move(p)}, map_{m}, acc_{} {}
+	constexpr mdspan(data_handle_type p, const mapping_type& m, const accessor_type& a) : ptr_{std::move(p)}, map_{m}, acc_{a} {}
+
+	template <typename...OtherIndexTypes>
+	requires (sizeof...(OtherIndexTypes) == rank() && (std::is_convertible_v<OtherIndexTypes, index_type> && ...))
+	constexpr reference operator[](OtherIndexTypes...indices) const
+	{
+		return acc_.access(ptr_, static_cast<std::size_t>(map_(static_cast<index_type>(indices)...)));
+	}
+
+	template <typename OtherIndexType>
+	requires std::is_convertible_v<const OtherIndexType&, index_type>
+	constexpr reference operator[](const std::array<OtherIndexType, rank()>& indices) const
+	{
+		return [this, &indices]<std::size_t...Is>(std::index_sequence<Is...>) -> reference {
+			return (*this)[static_cast<index_type>(indices[Is])...];
+		}(std::make_index_sequence<rank()>{});
+	}
+
+	constexpr size_type size() const noexcept { return static_cast<size_type>(extents_product(extents(), 0, rank())); }
+	constexpr bool empty() const noexcept { return size() == 0; }
+
+	constexpr const extents_type& extents() const noexcept { return map_.extents(); }
+	constexpr const data_handle_type& data_handle() const noexcept { return ptr_; }
+	constexpr const mapping_type& mapping() const noexcept { return map_; }
+	constexpr const accessor_type& accessor() const noexcept { return acc_; }
+
+	static constexpr bool is_always_unique() { return mapping_type::is_always_unique(); }
+	static constexpr bool is_always_exhaustive() { return mapping_type::is_always_exhaustive(); }
+	static constexpr bool is_always_strided() { return mapping_type::is_always_strided(); }
+	constexpr bool is_unique() const { return map_.is_unique(); }
+	constexpr bool is_exhaustive() const { return map_.is_exhaustive(); }
+	constexpr bool is_strided() const { return map_.is_strided(); }
+	constexpr index_type stride(rank_type r) const { return map_.stride(r); }
+
+private:
+	data_handle_type ptr_{};
+	mapping_type map_{};
+	accessor_type acc_{};
+};
+
+}
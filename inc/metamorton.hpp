@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "metarray.hpp"
+#include "metalgo.hpp"
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace metarray {
+
+// --- morton layout -----------------------------------------------------------------------------------------------------------------------
+// the low bits of x, moved to the set bits of mask (pdep).
+constexpr std::uint64_t deposit_bits(std::uint64_t x, std::uint64_t mask)
+{
+#if defined(__BMI2__)
+	if !consteval {
+		return _pdep_u64(x, mask);
+	}
+#endif
+	std::uint64_t result{0};
+	for (std::uint64_t bit{1}; mask != 0; bit <<= 1, mask &= mask - 1) {
+		result |= (x & bit) != 0 ? mask & (~mask + 1) : 0;
+	}
+	return result;
+}
+
+// the bits of x at the set bits of mask, packed into the low bits (pext).
+constexpr std::uint64_t extract_bits(std::uint64_t x, std::uint64_t mask)
+{
+#if defined(__BMI2__)
+	if !consteval {
+		return _pext_u64(x, mask);
+	}
+#endif
+	std::uint64_t result{0};
+	for (std::uint64_t bit{1}; mask != 0; bit <<= 1, mask &= mask - 1) {
+		result |= (x & mask & (~mask + 1)) != 0 ? bit : 0;
+	}
+	return result;
+}
+
+// z-order codes for indices within Extents. every axis takes bit_width(extent - 1) bits, and the code interleaves them from the lowest
+// bit up, innermost axis first - once the shorter axes run out of bits, the remaining ones carry on alone. items close together along
+// any axis end up close together in the code.
+template <index_sequence Extents>
+requires (Extents::size() > 0)
+struct morton_layout {
+	inline static constexpr std::size_t rank{Extents::size()};
+	inline static constexpr auto extents{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+		return std::array<std::size_t, rank>{Es...};
+	}(Extents{})};
+
+	// bits of the code that hold the index along each axis
+	inline static constexpr auto masks{[] {
+		std::array<std::size_t, rank> bits{};
+		for (std::size_t r{0}; r < rank; ++r) {
+			bits[r] = static_cast<std::size_t>(std::bit_width(extents[r] - 1));
+		}
+
+		std::array<std::uint64_t, rank> result{};
+		std::size_t position{0};
+		for (std::size_t b{0}; b < *std::ranges::max_element(bits); ++b) {
+			for (std::size_t r{rank}; r-- > 0;) {
+				if (b < bits[r]) {
+					result[r] |= std::uint64_t{1} << position++;
+				}
+			}
+		}
+		return result;
+	}()};
+
+	// codes run from 0 to size - 1, with gaps wherever an extent isn't a power of 2.
+	inline static constexpr std::size_t size{[] {
+		std::uint64_t all{0};
+		for (const auto mask : masks) {
+			all |= mask;
+		}
+		return static_cast<std::size_t>(all) + 1;
+	}()};
+
+	static constexpr std::size_t encode(const std::array<std::size_t, rank>& index)
+	{
+		std::uint64_t code{0};
+		for (std::size_t r{0}; r < rank; ++r) {
+			code |= deposit_bits(index[r], masks[r]);
+		}
+		return static_cast<std::size_t>(code);
+	}
+
+	static constexpr std::array<std::size_t, rank> decode(std::size_t code)
+	{
+		std::array<std::size_t, rank> index{};
+		for (std::size_t r{0}; r < rank; ++r) {
+			index[r] = static_cast<std::size_t>(extract_bits(code, masks[r]));
+		}
+		return index;
+	}
+
+	// code of the next item along Axis, without decoding: the bits of the other axes are set so the carry runs through them.
+	template <std::size_t Axis>
+	requires (Axis < rank)
+	static constexpr std::size_t next(std::size_t code)
+	{
+		constexpr auto mask{masks[Axis]};
+		return static_cast<std::size_t>((((code | ~mask) + 1) & mask) | (code & ~mask));
+	}
+};
+
+// array with the given (logical) extents, stored in z-order (morton_layout) so that small 2-d/3-d neighborhoods share cache lines and
+// pages along every axis, not just the innermost one. get with an indexer type or a runtime indexer interleaves the indices straight into
+// the storage index (with pdep where BMI2 is available); at_offset splits the row-major offset first. storage has room for the next power
+// of 2 along every axis - the unused slots stay T{}. that's up to 2^rank times the items when every extent is just past a power of 2
+// (129x129x129 is stored as 256x256x256, nearly 8 times its items), so the layout pays off for extents at or just under powers of 2.
+template <typename T, index_sequence Extents>
+requires (Extents::size() >= 2 && std::bit_width(morton_layout<Extents>::size - 1) <= 64)
+struct morton_array {
+	using extents_type = Extents;
+	using value_type = T;
+	using layout = morton_layout<Extents>;
+
+	std::array<T, layout::size> items;
+
+	constexpr T& at_index(const std::array<std::size_t, Extents::size()>& index)
+	{
+		return items[layout::encode(index)];
+	}
+
+	constexpr const T& at_index(const std::array<std::size_t, Extents::size()>& index) const
+	{
+		return items[layout::encode(index)];
+	}
+
+	constexpr T& at_offset(std::size_t offset)
+	{
+		return at_index(runtime_indexer_from_offset<Extents>(offset).index);
+	}
+
+	constexpr const T& at_offset(std::size_t offset) const
+	{
+		return at_index(runtime_indexer_from_offset<Extents>(offset).index);
+	}
+};
+
+// visits the morton code of every item in row-major order: f(code, offset). codes step along the innermost axis without re-encoding.
+template <index_sequence Extents, typename F>
+constexpr void for_each_morton_code(F&& f)
+{
+	using layout_t = morton_layout<Extents>;
+	constexpr auto row_items{layout_t::extents.back()};
+	constexpr auto rows{[] {
+		std::size_t product{1};
+		for (std::size_t r{0}; r + 1 < layout_t::rank; ++r) {
+			product *= layout_t::extents[r];
+		}
+		return product;
+	}()};
+
+	for (std::size_t row{0}; row < rows; ++row) {
+		auto code{layout_t::encode(runtime_indexer_from_offset<Extents>(row * row_items).index)};
+		for (std::size_t i{0}; i < row_items; ++i) {
+			f(code, row * row_items + i);
+			code = layout_t::template next<layout_t::rank - 1>(code);
+		}
+	}
+}
+
+// copy of any array into a morton_array with the same extents.
+template <array A>
+constexpr morton_array<remove_all_extents_t<A>, extents_of_t<A>> make_morton(const A& a)
+{
+	morton_array<remove_all_extents_t<A>, extents_of_t<A>> result{};
+	auto item{offset_accessor(a)};
+	for_each_morton_code<extents_of_t<A>>([&](std::size_t code, std::size_t offset) {
+		result.items[code] = item(offset);
+	});
+	return result;
+}
+
+// copy of a morton_array in plain row-major nested std::arrays.
+template <typename T, index_sequence Extents>
+constexpr std_array_of_t<T, Extents> to_row_major(const morton_array<T, Extents>& a)
+{
+	std_array_of_t<T, Extents> result{};
+	auto item{offset_accessor(result)};
+	for_each_morton_code<Extents>([&](std::size_t code, std::size_t offset) {
+		item(offset) = a.items[code];
+	});
+	return result;
+}
+
+}//metarray
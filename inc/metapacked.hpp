@@ -0,0 +1,207 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "metarray.hpp"
+#include "metalgo.hpp"
+
+namespace metarray {
+
+// --- packed arrays -----------------------------------------------------------------------------------------------------------------------
+template <std::size_t Bits>
+using packed_item_t = std::conditional_t<Bits == 1, bool, std::uint8_t>;
+
+// array of Bits-bit unsigned items (bools for 1 bit) with the given extents, packed into 64-bit words in offset order. items never
+// straddle two words, and the unused slots of the last word stay 0. as a custom array, get and at_offset return the item by value;
+// the non-const at_offset returns a proxy that can be assigned to.
+template <std::size_t Bits, index_sequence Extents, typename T = packed_item_t<Bits>>
+requires ((Bits == 1 || Bits == 2 || Bits == 4) && Extents::size() > 0 && (std::integral<T> || std::is_enum_v<T>))
+struct packed_array {
+	using extents_type = Extents;
+	using value_type = T;
+	using word_type = std::uint64_t;
+
+	inline static constexpr std::size_t bits{Bits};
+	inline static constexpr std::size_t items_per_word{64 / Bits};
+	inline static constexpr word_type item_mask{(word_type{1} << Bits) - 1};
+	inline static constexpr std::size_t total{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+		return (std::size_t{1} * ... * Es);
+	}(Extents{})};
+
+	std::array<word_type, (total + items_per_word - 1) / items_per_word> words;
+
+	class reference {
+	public:
+		constexpr reference(packed_array& a, std::size_t offset) : a_{&a}, offset_{offset} {}
+		constexpr reference(const reference&) = default;
+
+		constexpr operator T() const
+		{
+			return std::as_const(*a_).at_offset(offset_);
+		}
+
+		constexpr const reference& operator=(T item) const
+		{
+			a_->set(offset_, item);
+			return *this;
+		}
+
+		// copies the item referred to, like assigning through a plain reference - it doesn't rebind.
+		constexpr const reference& operator=(const reference& other) const
+		{
+			a_->set(offset_, T(other));
+			return *this;
+		}
+
+	private:
+		packed_array* a_;
+		std::size_t offset_;
+	};
+
+	constexpr T at_offset(std::size_t offset) const
+	{
+		return static_cast<T>(words[offset / items_per_word] >> (offset % items_per_word * Bits) & item_mask);
+	}
+
+	constexpr reference at_offset(std::size_t offset)
+	{
+		return {*this, offset};
+	}
+
+	constexpr void set(std::size_t offset, T item)
+	{
+		const auto shift{offset % items_per_word * Bits};
+		auto& word{words[offset / items_per_word]};
+		word = (word & ~(item_mask << shift)) | ((static_cast<word_type>(item) & item_mask) << shift);
+	}
+
+	// item repeated in every slot of a word.
+	static constexpr word_type broadcast(word_type item)
+	{
+		return (~word_type{0} / item_mask) * (item & item_mask);
+	}
+
+	// lowest bit of every slot of word that holds item.
+	static constexpr word_type matches(word_type word, word_type item)
+	{
+		auto x{~(word ^ broadcast(item))};
+		// and-fold the bits of each slot down into its lowest bit
+		for (std::size_t b{1}; b < Bits; b *= 2) {
+			x &= x >> b;
+		}
+		return x & broadcast(1);
+	}
+};
+
+// copy of any array of small unsigned items (or bools) into a packed_array with the same extents. bits above Bits are dropped.
+template <std::size_t Bits, array A, typename T = packed_item_t<Bits>>
+constexpr packed_array<Bits, extents_of_t<A>, T> make_packed(const A& a)
+{
+	packed_array<Bits, extents_of_t<A>, T> result{};
+	for_each_run(a, [&result](auto run, std::size_t offset) {
+		for (std::size_t i{0}; i < run.size(); ++i) {
+			result.set(offset + i, static_cast<T>(run[i]));
+		}
+	});
+	return result;
+}
+
+// sum of all items: bit b of every slot counts 2^b, so it's a popcount per bit of the slot over every word.
+template <std::size_t Bits, index_sequence Extents, typename T>
+constexpr std::size_t sum(const packed_array<Bits, Extents, T>& a)
+{
+	using array_t = packed_array<Bits, Extents, T>;
+	const instrument_scope<array_t> instrument{"sum"};
+	std::array<std::size_t, Bits> counts{};
+	for (const auto word : a.words) {
+		for (std::size_t b{0}; b < Bits; ++b) {
+			counts[b] += static_cast<std::size_t>(std::popcount(word & (array_t::broadcast(1) << b)));
+		}
+	}
+
+	std::size_t result{0};
+	for (std::size_t b{0}; b < Bits; ++b) {
+		result += counts[b] << b;
+	}
+	return result;
+}
+
+// number of items equal to item, one word (items_per_word items) at a time. items that don't fit in Bits are never found.
+template <std::size_t Bits, index_sequence Extents, typename T>
+constexpr std::size_t count(const packed_array<Bits, Extents, T>& a, T item)
+{
+	using array_t = packed_array<Bits, Extents, T>;
+	const instrument_scope<array_t> instrument{"count"};
+	const auto value{static_cast<typename array_t::word_type>(item)};
+	if (value > array_t::item_mask) {
+		return 0;
+	}
+
+	std::size_t result{0};
+	for (const auto word : a.words) {
+		result += static_cast<std::size_t>(std::popcount(array_t::matches(word, value)));
+	}
+	// the unused slots of the last word hold 0
+	return result - (value == 0 ? a.words.size() * array_t::items_per_word - array_t::total : 0);
+}
+
+// indexer of the first item equal to item, if there is one.
+template <std::size_t Bits, index_sequence Extents, typename T>
+constexpr std::optional<runtime_indexer<Extents>> find(const packed_array<Bits, Extents, T>& a, T item)
+{
+	using array_t = packed_array<Bits, Extents, T>;
+	const auto value{static_cast<typename array_t::word_type>(item)};
+	if (value > array_t::item_mask) {
+		return std::nullopt;
+	}
+
+	for (std::size_t w{0}; w < a.words.size(); ++w) {
+		if (const auto found{array_t::matches(a.words[w], value)}; found != 0) {
+			const auto offset{w * array_t::items_per_word + static_cast<std::size_t>(std::countr_zero(found)) / Bits};
+			if (offset < array_t::total) {
+				return runtime_indexer_from_offset<Extents>(offset);
+			}
+		}
+	}
+	return std::nullopt;
+}
+
+// bit v is set if some item is v. one equality test per possible item and word, stopping as soon as every item has been seen.
+template <std::size_t Bits, index_sequence Extents, typename T>
+constexpr std::uint32_t items_present(const packed_array<Bits, Extents, T>& a)
+{
+	using array_t = packed_array<Bits, Extents, T>;
+	constexpr std::uint32_t all{(std::uint32_t{1} << (std::size_t{1} << Bits)) - 1};
+	constexpr auto full_words{array_t::total / array_t::items_per_word};
+
+	std::uint32_t present{0};
+	for (std::size_t w{0}; w < full_words && present != all; ++w) {
+		for (std::uint32_t v{0}; v < (std::uint32_t{1} << Bits); ++v) {
+			present |= array_t::matches(a.words[w], v) != 0 ? std::uint32_t{1} << v : 0u;
+		}
+	}
+	for (std::size_t offset{full_words * array_t::items_per_word}; offset < array_t::total; ++offset) {
+		present |= std::uint32_t{1} << static_cast<std::uint32_t>(a.at_offset(offset));
+	}
+	return present;
+}
+
+template <std::size_t Bits, index_sequence Extents, typename T>
+constexpr T min(const packed_array<Bits, Extents, T>& a)
+{
+	return static_cast<T>(std::countr_zero(items_present(a)));
+}
+
+template <std::size_t Bits, index_sequence Extents, typename T>
+constexpr T max(const packed_array<Bits, Extents, T>& a)
+{
+	return static_cast<T>(std::bit_width(items_present(a)) - 1);
+}
+
+}//metarray
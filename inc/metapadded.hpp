@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "metarray.hpp"
+#include "metalgo.hpp"
+
+namespace metarray {
+
+// --- padded arrays -----------------------------------------------------------------------------------------------------------------------
+// array with the given (logical) extents whose innermost rows each start on an Align boundary and are padded to a whole number of Align
+// bytes - row_stride items apart. traits, get, for_each_run etc. only ever see the logical items. the padding stays T{}: sum and
+// count_if run over whole padded rows (padding added in or subtracted out), the block kernels (reduce_many, argmin/argmax/minmax_element,
+// count_if with any predicate, histogram) read the last block of each row whole through for_each_padded_run and mask the padding, and
+// the axis reductions walk the padded rows in place. the scans still return plain std::arrays, so they only read the rows once, into
+// that result - the scan itself runs on the unpadded copy.
+template <typename T, index_sequence Extents, std::size_t Align = simd_bytes>
+requires (Extents::size() > 0 && Align % alignof(T) == 0 && Align % sizeof(T) == 0)
+struct padded_array {
+	using extents_type = Extents;
+	using value_type = T;
+
+	inline static constexpr std::size_t row_items{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+		return std::array<std::size_t, sizeof...(Es)>{Es...}.back();
+	}(Extents{})};
+	inline static constexpr std::size_t rows{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+		return (std::size_t{1} * ... * Es);
+	}(Extents{}) / row_items};
+	inline static constexpr std::size_t row_stride{(row_items * sizeof(T) + Align - 1) / Align * Align / sizeof(T)};
+	// widest block of simd lanes that tiles a padded row exactly
+	inline static constexpr std::size_t row_lanes{std::min(simd_lanes_v<T>, row_stride & (~row_stride + 1))};
+
+	// row r occupies items[r * row_stride] ... items[r * row_stride + row_items - 1]. the rest must stay T{}.
+	alignas(Align) std::array<T, rows * row_stride> items;
+
+	constexpr T& at_offset(std::size_t offset)
+	{
+		return items[offset / row_items * row_stride + offset % row_items];
+	}
+
+	constexpr const T& at_offset(std::size_t offset) const
+	{
+		return items[offset / row_items * row_stride + offset % row_items];
+	}
+
+	template <typename F>
+	constexpr void for_each_run(F&& f) const
+	{
+		for (std::size_t r{0}; r < rows; ++r) {
+			f(std::span<const T>{items.data() + r * row_stride, row_items}, r * row_items);
+		}
+	}
+
+	template <typename F>
+	constexpr void for_each_run(F&& f)
+	{
+		for (std::size_t r{0}; r < rows; ++r) {
+			f(std::span<T>{items.data() + r * row_stride, row_items}, r * row_items);
+		}
+	}
+
+	template <typename F>
+	constexpr void for_each_padded_run(F&& f) const
+	{
+		for (std::size_t r{0}; r < rows; ++r) {
+			f(std::span<const T>{items.data() + r * row_stride, row_stride}, r * row_items, row_items);
+		}
+	}
+
+	// row r including its padding.
+	constexpr std::span<const T, row_stride> padded_row(std::size_t r) const
+	{
+		if consteval {
+			return std::span<const T, row_stride>{items.data() + r * row_stride, row_stride};
+		}
+		else {
+			return std::span<const T, row_stride>{std::assume_aligned<Align>(items.data() + r * row_stride), row_stride};
+		}
+	}
+};
+
+// copy of any array into a padded_array with the same extents.
+template <std::size_t Align = simd_bytes, array A>
+constexpr padded_array<remove_all_extents_t<A>, extents_of_t<A>, Align> make_padded(const A& a)
+{
+	padded_array<remove_all_extents_t<A>, extents_of_t<A>, Align> result{};
+	for_each_run(a, [&result](auto run, std::size_t offset) {
+		for (std::size_t i{0}; i < run.size(); ++i) {
+			result.at_offset(offset + i) = run[i];
+		}
+	});
+	return result;
+}
+
+// whole padded rows in blocks of row_lanes - they tile each padded row, so there's no remainder.
+template <typename T, index_sequence Extents, std::size_t Align>
+constexpr auto sum(const padded_array<T, Extents, Align>& a)
+{
+	using sum_t = decltype(T{} + T{});
+	using array_t = padded_array<T, Extents, Align>;
+	const instrument_scope<array_t> instrument{"sum"};
+	constexpr auto lanes{array_t::row_lanes};
+
+	std::array<sum_t, lanes> sums{};
+	for (std::size_t r{0}; r < array_t::rows; ++r) {
+		const auto row{a.padded_row(r)};
+		for (std::size_t i{0}; i < row.size(); i += lanes) {
+			for (std::size_t l{0}; l < lanes; ++l) {
+				sums[l] += row[i + l];
+			}
+		}
+	}
+
+	sum_t result{};
+	for (const auto s : sums) {
+		result += s;
+	}
+	return result;
+}
+
+// padded rows in place: along the rows with reduce_inner striding over the padding, along an outer axis with reduce_outer over whole
+// padded rows into a padded scratch result, whose logical items are copied out at the end.
+template <std::size_t Axis, typename T, index_sequence Extents, std::size_t Align, typename U, typename BinOp>
+requires (Axis < Extents::size())
+constexpr reduced_array_t<padded_array<T, Extents, Align>, Axis, U> reduce_axis(const padded_array<T, Extents, Align>& a,
+	const std::optional<U>& init, BinOp op)
+{
+	using array_t = padded_array<T, Extents, Align>;
+	const instrument_scope<array_t> instrument{"axis reduction"};
+	constexpr auto outer{outer_items_v<array_t, Axis>};
+	constexpr auto n{extent_v<array_t, Axis>};
+	constexpr auto inner{inner_items_v<array_t, Axis>};
+
+	std::conditional_t<Extents::size() == 1, std::array<U, 1>, reduced_array_t<array_t, Axis, U>> result{};
+	const auto item{[&a](std::size_t offset) -> const T& { return a.items[offset]; }};
+	auto result_item{offset_accessor(result)};
+
+	if constexpr (inner == 1) {
+		reduce_inner<U, outer, n, array_t::row_stride>(item, result_item, init, op);
+	}
+	else {
+		constexpr auto padded_inner{inner / array_t::row_items * array_t::row_stride};
+		std::array<U, outer * padded_inner> padded_result{};
+		reduce_outer<U, outer, n, padded_inner>(item, [&padded_result](std::size_t offset) -> U& { return padded_result[offset]; }, init, op);
+		for (std::size_t r{0}; r < outer * inner / array_t::row_items; ++r) {
+			for (std::size_t i{0}; i < array_t::row_items; ++i) {
+				result_item(r * array_t::row_items + i) = padded_result[r * array_t::row_stride + i];
+			}
+		}
+	}
+
+	if constexpr (Extents::size() == 1) {
+		return result[0];
+	}
+	else {
+		return result;
+	}
+}
+
+// pred also runs on the padding - those T{} items are taken back out at the end.
+template <typename T, index_sequence Extents, std::size_t Align, typename Pred>
+constexpr std::size_t count_if(const padded_array<T, Extents, Align>& a, Pred pred)
+{
+	using array_t = padded_array<T, Extents, Align>;
+	const instrument_scope<array_t> instrument{"count_if"};
+	constexpr auto lanes{array_t::row_lanes};
+
+	std::array<std::size_t, lanes> counts{};
+	for (std::size_t r{0}; r < array_t::rows; ++r) {
+		const auto row{a.padded_row(r)};
+		for (std::size_t i{0}; i < row.size(); i += lanes) {
+			for (std::size_t l{0}; l < lanes; ++l) {
+				counts[l] += pred(row[i + l]) ? 1u : 0u;
+			}
+		}
+	}
+
+	std::size_t count{0};
+	for (const auto c : counts) {
+		count += c;
+	}
+	return count - (pred(T{}) ? array_t::rows * (array_t::row_stride - array_t::row_items) : 0u);
+}
+
+}//metarray
@@ -1,12 +1,33 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cassert>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#if __has_include(<mdspan>)
+#include <mdspan>
+#endif
+#ifndef __cpp_lib_mdspan
+#include "metamdspan.hpp"
+#endif
 
 namespace metarray {
+// std::mdspan where the standard library has it, the reference implementation in metamdspan.hpp otherwise.
+#ifdef __cpp_lib_mdspan
+namespace stdex = std;
+#else
+namespace stdex = mdspan_ref;
+#endif
+
 // --- array traits/concepts ---------------------------------------------------------------------------------------------------------------
 template <typename T>
 concept c_array = std::is_array_v<T>;
@@ -23,6 +44,10 @@ inline constexpr auto is_std_array_v{is_std_array<std::remove_cv_t<T>>::value};
 template <typename T>
 concept std_array = is_std_array_v<T>;
 
+// c-arrays and (nested) std::arrays - the array types that are sliced one extent at a time with a[i].
+template <typename T>
+concept nested_array = c_array<T> || std_array<T>;
+
 template <typename>
 struct is_array : std::false_type{};
 
@@ -32,12 +57,45 @@ struct is_array<T> : std::true_type{};
 template <typename T, std::size_t S>
 struct is_array<std::array<T, S>> : std::true_type{};
 
+// only mdspans with fully static extents are arrays - the extents need to be part of the type, just like c-arrays and std::arrays.
+template <typename>
+struct is_std_mdspan : std::false_type{};
+
+template <typename T, typename Extents, typename Layout, typename Accessor>
+requires (Extents::rank() > 0 && Extents::rank_dynamic() == 0)
+struct is_std_mdspan<stdex::mdspan<T, Extents, Layout, Accessor>> : std::true_type{};
+
+template <typename T>
+inline constexpr auto is_std_mdspan_v{is_std_mdspan<std::remove_cv_t<T>>::value};
+
+template <typename T>
+concept std_mdspan = is_std_mdspan_v<T>;
+
+template <std_mdspan T>
+struct is_array<T> : std::true_type{};
+
 template <typename T>
 inline constexpr auto is_array_v{is_array<std::remove_cv_t<T>>::value};
 
 template <typename T>
 concept array = is_array_v<T>;
 
+// arrays whose items are laid out contiguously in offset (row-major) order.
+template <typename T>
+struct is_contiguous_array : std::bool_constant<nested_array<T>>{};
+
+template <std_mdspan T>
+struct is_contiguous_array<T> : std::bool_constant<
+	std::is_same_v<typename T::layout_type, stdex::layout_right>
+	&& std::is_same_v<typename T::accessor_type, stdex::default_accessor<typename T::element_type>>
+>{};
+
+template <typename T>
+inline constexpr auto is_contiguous_array_v{is_contiguous_array<std::remove_cv_t<T>>::value};
+
+template <typename T>
+concept contiguous_array = is_contiguous_array_v<T>;
+
 // --- array ranks -------------------------------------------------------------------------------------------------------------------------
 template <typename T>
 struct rank : std::integral_constant<std::size_t, 0>{};
@@ -48,6 +106,9 @@ struct rank<T> : std::rank<T>{};
 template <std_array T>
 struct rank<T> : std::integral_constant<std::size_t, rank<typename T::value_type>::value + 1>{};
 
+template <std_mdspan T>
+struct rank<T> : std::integral_constant<std::size_t, T::rank()>{};
+
 template <typename T>
 inline constexpr auto rank_v{rank<T>::value};
 
@@ -67,6 +128,9 @@ struct extent<T, 0> : std::integral_constant<std::size_t, std::tuple_size_v<T>>{
 template <std_array T, std::size_t I>
 struct extent<T, I> : extent<typename T::value_type, I - 1>{};
 
+template <std_mdspan T, std::size_t I>
+struct extent<T, I> : std::integral_constant<std::size_t, (I < T::rank() ? T::static_extent(I) : 0)>{};
+
 template <array T, std::size_t I>
 inline constexpr auto extent_v{extent<T, I>::value};
 
@@ -115,9 +179,31 @@ struct remove_all_extents<T> {
 	using type = typename remove_all_extents<typename T::value_type>::type;
 };
 
+template <std_mdspan T>
+struct remove_all_extents<T> {
+	using type = typename std::remove_cv_t<T>::value_type;
+};
+
 template <typename T>
 using remove_all_extents_t = typename remove_all_extents<T>::type;
 
+// nested std::array with the given item type and extents - the owning result type of algorithms that produce a new array.
+template <typename...>
+struct std_array_of;
+
+template <typename T>
+struct std_array_of<T, std::index_sequence<>> {
+	using type = T;
+};
+
+template <typename T, std::size_t E, std::size_t...Es>
+struct std_array_of<T, std::index_sequence<E, Es...>> {
+	using type = std::array<typename std_array_of<T, std::index_sequence<Es...>>::type, E>;
+};
+
+template <typename T, typename Extents>
+using std_array_of_t = std_array_of<T, Extents>::type;
+
 template <typename...>
 struct total_items;
 
@@ -136,6 +222,17 @@ struct total_items<T> {
 	inline static constexpr auto value{std::tuple_size_v<T> * total_items<std::remove_cvref_t<remove_extent_t<T>>>::value};
 };
 
+template <std_mdspan T>
+struct total_items<T> {
+	inline static constexpr auto value{[]{
+		std::size_t items{1};
+		for (std::size_t i{0}; i < T::rank(); ++i) {
+			items *= T::static_extent(i);
+		}
+		return items;
+	}()};
+};
+
 template <array T>
 inline constexpr auto total_items_v{total_items<T>::value};
 
@@ -152,6 +249,64 @@ inline constexpr bool is_index_sequence_v{is_index_sequence<T>::value};
 template <typename T>
 concept index_sequence = is_index_sequence_v<T>;
 
+// --- custom arrays -----------------------------------------------------------------------------------------------------------------------
+// any type can join in as an array by providing:
+//   extents_type - std::index_sequence of its extents
+//   value_type - the item type
+//   at_offset(offset) - item (or a reference/proxy to it) at a row-major offset
+// and optionally
+//   for_each_run(f) - with the semantics of metarray::for_each_run, if the items are stored in contiguous runs
+//   for_each_padded_run(f) - f(std::span run, std::size_t offset, std::size_t items) for each run whose first items items are the ones
+//     from offset on and whose remaining items are padding the kernels may read (but not count on)
+//   at_index(index) - item at a std::array of indices, if that's cheaper than going through the row-major offset
+template <typename T>
+concept custom_array = requires (const T& a, std::size_t offset) {
+	typename T::extents_type;
+	typename T::value_type;
+	requires is_index_sequence_v<typename T::extents_type>;
+	requires T::extents_type::size() > 0;
+	{ a.at_offset(offset) } -> std::convertible_to<typename T::value_type>;
+};
+
+template <typename T>
+concept custom_array_with_runs = custom_array<T> && requires (T& a) {
+	a.for_each_run([](auto, std::size_t) {});
+};
+
+template <typename T>
+concept custom_array_with_padded_runs = custom_array<T> && requires (T& a) {
+	a.for_each_padded_run([](auto, std::size_t, std::size_t) {});
+};
+
+template <typename T>
+concept custom_array_with_index = custom_array<T> && requires (T& a, const std::array<std::size_t, T::extents_type::size()>& index) {
+	a.at_index(index);
+};
+
+template <custom_array T>
+struct is_array<T> : std::true_type{};
+
+template <custom_array T>
+struct rank<T> : std::integral_constant<std::size_t, T::extents_type::size()>{};
+
+template <custom_array T, std::size_t I>
+struct extent<T, I> : std::integral_constant<std::size_t, []<std::size_t...Es>(const std::index_sequence<Es...>&) {
+	constexpr std::array<std::size_t, sizeof...(Es)> extents{Es...};
+	return I < extents.size() ? extents[I] : 0;
+}(typename T::extents_type{})>{};
+
+template <custom_array T>
+struct remove_all_extents<T> {
+	using type = typename std::remove_cv_t<T>::value_type;
+};
+
+template <custom_array T>
+struct total_items<T> {
+	inline static constexpr auto value{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+		return (std::size_t{1} * ... * Es);
+	}(typename T::extents_type{})};
+};
+
 // --- indexer -----------------------------------------------------------------------------------------------------------------------------
 template <std::size_t>
 inline constexpr std::size_t zero_index{0};
@@ -305,6 +460,30 @@ struct index_sequence_trailing<std::index_sequence<Head, Tail...>> {
 template <typename Seq>
 using index_sequence_trailing_t = index_sequence_trailing<Seq>::type;
 
+template <typename...>
+struct index_sequence_erase;
+
+template <std::size_t...S, std::size_t I>
+requires (I < sizeof...(S))
+struct index_sequence_erase<std::index_sequence<S...>, std::integral_constant<std::size_t, I>> {
+private:
+	inline static constexpr std::array<std::size_t, sizeof...(S)> values{S...};
+
+	template <std::size_t...Is>
+	static auto erase(const std::index_sequence<Is...>&) -> std::index_sequence<values[Is < I ? Is : Is + 1]...>;
+
+public:
+	using type = decltype(erase(std::make_index_sequence<sizeof...(S) - 1>{}));
+};
+
+template <index_sequence Seq, std::size_t I>
+using index_sequence_erase_t = index_sequence_erase<Seq, std::integral_constant<std::size_t, I>>::type;
+
+// extents of T with the extent of Axis removed - the shape left over after reducing along Axis.
+template <array T, std::size_t Axis>
+requires (Axis < rank_v<T>)
+using reduced_extents_of_t = index_sequence_erase_t<extents_of_t<T>, Axis>;
+
 template <typename...>
 struct is_first_indexer;
 
@@ -430,6 +609,149 @@ public:
 template <valid_indexer Idx>
 inline constexpr auto offset_from_indexer_v{offset_from_indexer<Idx>::value};
 
+// smallest unsigned type that holds every offset of an array with N items.
+template <std::size_t N>
+using least_offset_t = std::conditional_t<(N <= (std::size_t{1} << 8)), std::uint8_t,
+	std::conditional_t<(N <= (std::size_t{1} << 16)), std::uint16_t,
+	std::conditional_t<(N <= (std::size_t{1} << 32)), std::uint32_t, std::uint64_t>>>;
+
+// --- runtime indexer ---------------------------------------------------------------------------------------------------------------------
+// runtime counterpart of the indexer types - the indices are values, but the extents are still part of the type.
+template <typename...>
+struct runtime_indexer;
+
+template <std::size_t...Es>
+requires ((Es > 0) && ...)
+struct runtime_indexer<std::index_sequence<Es...>> {
+	using extents_type = std::index_sequence<Es...>;
+
+	std::array<std::size_t, sizeof...(Es)> index;
+
+	constexpr bool operator==(const runtime_indexer&) const = default;
+};
+
+template <array A>
+using runtime_indexer_of_t = runtime_indexer<extents_of_t<A>>;
+
+template <typename...>
+struct to_runtime_indexer;
+
+template <std::size_t...Is, std::size_t...Es>
+requires (valid_indexer<std::pair<std::index_sequence<Is...>, std::index_sequence<Es...>>>)
+struct to_runtime_indexer<std::pair<std::index_sequence<Is...>, std::index_sequence<Es...>>> {
+	inline static constexpr runtime_indexer<std::index_sequence<Es...>> value{{Is...}};
+};
+
+// runtime indexer equal to the indexer type Idx.
+template <valid_indexer Idx>
+inline constexpr auto to_runtime_indexer_v{to_runtime_indexer<std::remove_cvref_t<Idx>>::value};
+
+// n / divisor as n * multiplier >> shift, exact for every n < bound. multiplier is 0 if no 64-bit multiplier works for the whole range -
+// divide() then falls back to the hardware division.
+struct divisor_magic {
+	std::uint64_t divisor;
+	std::uint64_t multiplier;
+	unsigned shift;
+
+	constexpr std::uint64_t divide(std::uint64_t n) const
+	{
+		return multiplier != 0 ? n * multiplier >> shift : n / divisor;
+	}
+};
+
+// with multiplier = ceil(2^shift / divisor) = (2^shift + error) / divisor, n * multiplier / 2^shift is n / divisor plus less than
+// 1 / divisor as long as n * error < 2^shift - so flooring it gives the quotient. the smallest such shift keeps n * multiplier in 64 bits
+// for the largest offsets.
+constexpr divisor_magic make_divisor_magic(std::uint64_t divisor, std::uint64_t bound)
+{
+	const auto n_max{bound - 1};
+	for (unsigned shift{0}; shift < 64; ++shift) {
+		const auto power{std::uint64_t{1} << shift};
+		const auto multiplier{power / divisor + (power % divisor != 0 ? 1 : 0)};
+		const auto error{multiplier * divisor - power};
+		if (multiplier != 0 && (error == 0 || n_max <= (power - 1) / error) && n_max <= ~std::uint64_t{0} / multiplier) {
+			return {divisor, multiplier, shift};
+		}
+	}
+	return {divisor, 0, 0};
+}
+
+// the divisors runtime_indexer_from_offset uses for each axis. walking from the innermost axis outwards, what's left of the offset at
+// axis r is less than the product of the extents up to and including r.
+template <index_sequence Extents>
+inline constexpr auto offset_divisors_v{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+	constexpr std::array<std::size_t, sizeof...(Es)> extents{Es...};
+	std::array<divisor_magic, sizeof...(Es)> divisors{};
+	std::uint64_t bound{1};
+	for (std::size_t r{0}; r < extents.size(); ++r) {
+		bound *= extents[r];
+		divisors[r] = make_divisor_magic(extents[r], bound);
+	}
+	return divisors;
+}(Extents{})};
+
+// one step of turning an offset into an indexer: the index along axis R (returned) and what's left of offset for the outer axes.
+template <index_sequence Extents, std::size_t R>
+constexpr std::size_t split_offset(std::size_t& offset)
+{
+	constexpr auto divisor{offset_divisors_v<Extents>[R]};
+
+	const auto quotient{static_cast<std::size_t>(divisor.divide(offset))};
+	const auto index{offset - quotient * divisor.divisor};
+	offset = quotient;
+	return index;
+}
+
+// offset must be less than the total number of items.
+template <index_sequence Extents>
+constexpr runtime_indexer<Extents> runtime_indexer_from_offset(std::size_t offset)
+{
+	runtime_indexer<Extents> idx{};
+	[&]<std::size_t...Rs>(const std::index_sequence<Rs...>&) {
+		((idx.index[Extents::size() - 1 - Rs] = split_offset<Extents, Extents::size() - 1 - Rs>(offset)), ...);
+	}(std::make_index_sequence<Extents::size()>{});
+	return idx;
+}
+
+template <array A>
+constexpr runtime_indexer_of_t<A> runtime_indexer_from_offset(const A&, std::size_t offset)
+{
+	return runtime_indexer_from_offset<extents_of_t<A>>(offset);
+}
+
+template <std::size_t...Es>
+constexpr std::size_t runtime_offset_from_indexer(const runtime_indexer<std::index_sequence<Es...>>& idx)
+{
+	constexpr std::array<std::size_t, sizeof...(Es)> extents{Es...};
+
+	std::size_t offset{0};
+	for (std::size_t r{0}; r < extents.size(); ++r) {
+		offset = offset * extents[r] + idx.index[r];
+	}
+	return offset;
+}
+
+// runtime_indexer_from_offset for every offset, into result (at least as long as offsets). there are no divisions left and the steps
+// are the same for every offset, so the loop vectorizes.
+template <index_sequence Extents>
+constexpr void runtime_indexers_from_offsets(std::span<const std::size_t> offsets, std::span<runtime_indexer<Extents>> result)
+{
+	assert(result.size() >= offsets.size());
+	for (std::size_t i{0}; i < offsets.size(); ++i) {
+		result[i] = runtime_indexer_from_offset<Extents>(offsets[i]);
+	}
+}
+
+// runtime_offset_from_indexer for every indexer, into result (at least as long as idxs).
+template <index_sequence Extents>
+constexpr void runtime_offsets_from_indexers(std::span<const runtime_indexer<Extents>> idxs, std::span<std::size_t> result)
+{
+	assert(result.size() >= idxs.size());
+	for (std::size_t i{0}; i < idxs.size(); ++i) {
+		result[i] = runtime_offset_from_indexer(idxs[i]);
+	}
+}
+
 // --- iteration ---------------------------------------------------------------------------------------------------------------------------
 //TODO: a std::variant list of indexers - worked fine, but didn't turn out to be helpful (yet). may still need this eventually.3
 // template <typename...>
@@ -574,12 +896,28 @@ template <typename IdxListA, typename IdxListB>
 using set_diff_t = typename set_diff<IdxListA, IdxListB>::type;
 
 // --- access ------------------------------------------------------------------------------------------------------------------------------
+template <std_mdspan M, std::size_t...Is>
+constexpr auto mdspan_get(const M& m, const std::index_sequence<Is...>&)
+{
+	return m[Is...];
+}
+
 //TODO: currently only supporting const array
 template <valid_indexer Idx, array A>
 requires (valid_indexer_of<A, Idx> && rank_v<A> > 0)
 constexpr auto get(const A& a)
 {
-	if constexpr (rank_v<A> == 1) {
+	if constexpr (std_mdspan<A>) {
+		// mdspan can't be sliced one extent at a time - all indices go to the mapping in one subscript.
+		return mdspan_get(a, typename std::remove_cvref_t<Idx>::first_type{});
+	}
+	else if constexpr (custom_array_with_index<A>) {
+		return a.at_index(to_runtime_indexer_v<Idx>.index);
+	}
+	else if constexpr (custom_array<A>) {
+		return a.at_offset(offset_from_indexer_v<std::remove_cvref_t<Idx>>);
+	}
+	else if constexpr (rank_v<A> == 1) {
 		return a[index_sequence_head_v<typename std::remove_cvref_t<Idx>::first_type>];
 	}
 	else {
@@ -592,6 +930,519 @@ constexpr auto get(const A& a)
 	}
 }
 
+// pointer to the first item of a c-array/std::array of any rank. nested arrays have no padding (see static_assert), so the items are
+// contiguous in offset order.
+template <nested_array A>
+constexpr auto flat_data(A& a)
+{
+	static_assert(sizeof(A) == sizeof(remove_all_extents_t<A>) * total_items_v<A>, "nested array storage must not be padded");
+
+	if constexpr (rank_v<A> == 1) {
+		return std::data(a);
+	}
+	else {
+		return flat_data(a[0]);
+	}
+}
+
+template <contiguous_array M>
+requires std_mdspan<M>
+constexpr auto flat_data(M& m)
+{
+	return m.data_handle();
+}
+
+template <array A, std::size_t...Is>
+constexpr auto mdspan_extents_of(const std::index_sequence<Is...>&)
+{
+	return stdex::extents<std::size_t, extent_v<A, Is>...>{};
+}
+
+template <array A, std::size_t...Is>
+constexpr auto mdspan_reverse_extents_of(const std::index_sequence<Is...>&)
+{
+	return stdex::extents<std::size_t, extent_v<A, rank_v<A> - 1 - Is>...>{};
+}
+
+// non-owning mdspan view over a c-array or (nested) std::array.
+//   layout_right: same extents and index order as the array - get<Idx>(to_mdspan(a)) == get<Idx>(a).
+//   layout_left: extents are reversed so the column-major walk visits the same storage - m[k, j, i] == a[i][j][k].
+//   layout_stride: same as layout_right, but with explicit strides that can be copied and adjusted for strided views.
+template <typename Layout = stdex::layout_right, nested_array A>
+constexpr auto to_mdspan(A& a)
+{
+	using item_t = std::remove_reference_t<decltype(*flat_data(a))>;
+	constexpr auto seq{std::make_index_sequence<rank_v<A>>{}};
+
+	if constexpr (std::is_same_v<Layout, stdex::layout_left>) {
+		return stdex::mdspan<item_t, decltype(mdspan_reverse_extents_of<A>(seq)), stdex::layout_left>{flat_data(a)};
+	}
+	else if constexpr (std::is_same_v<Layout, stdex::layout_stride>) {
+		using extents_t = decltype(mdspan_extents_of<A>(seq));
+		const stdex::layout_right::mapping<extents_t> row_major{};
+		std::array<std::size_t, rank_v<A>> strides{};
+		for (std::size_t i{0}; i < rank_v<A>; ++i) {
+			strides[i] = row_major.stride(i);
+		}
+		return stdex::mdspan<item_t, extents_t, stdex::layout_stride>{flat_data(a), stdex::layout_stride::mapping<extents_t>{extents_t{}, strides}};
+	}
+	else {
+		static_assert(std::is_same_v<Layout, stdex::layout_right>, "to_mdspan supports layout_right, layout_left and layout_stride");
+		return stdex::mdspan<item_t, decltype(mdspan_extents_of<A>(seq)), stdex::layout_right>{flat_data(a)};
+	}
+}
+
+// item at a runtime offset (row-major order) of any array. usable during constant evaluation, unlike flat_data(a)[offset].
+template <array A>
+constexpr decltype(auto) at_offset(A& a, std::size_t offset)
+{
+	if constexpr (custom_array<A>) {
+		return a.at_offset(offset);
+	}
+	else if constexpr (std_mdspan<A>) {
+		std::array<std::size_t, rank_v<A>> idx{};
+		for (std::size_t r{rank_v<A>}; r-- > 0;) {
+			const auto e{static_cast<std::size_t>(a.extent(r))};
+			idx[r] = offset % e;
+			offset /= e;
+		}
+		return std::apply([&a](auto...i) -> auto& { return a[i...]; }, idx);
+	}
+	else if constexpr (rank_v<A> == 1) {
+		return a[offset];
+	}
+	else {
+		constexpr auto sub_items{total_items_v<std::remove_cvref_t<decltype(a[0])>>};
+		return at_offset(a[offset / sub_items], offset % sub_items);
+	}
+}
+
+// random access by offset into any array. contiguous arrays use pointer arithmetic at runtime, everything else goes through at_offset.
+template <array A>
+constexpr auto offset_accessor(A& a)
+{
+	if constexpr (contiguous_array<A>) {
+		return [&a, data = flat_data(a)](std::size_t offset) constexpr -> decltype(auto) {
+			if consteval {
+				return at_offset(a, offset);
+			}
+			else {
+				return data[offset];
+			}
+		};
+	}
+	else {
+		return [&a](std::size_t offset) constexpr -> decltype(auto) { return at_offset(a, offset); };
+	}
+}
+
+template <nested_array A, typename F>
+constexpr void for_each_row(A& a, F& f, std::size_t offset)
+{
+	if constexpr (rank_v<A> == 1) {
+		f(std::span{std::data(a), std::size(a)}, offset);
+	}
+	else {
+		for (std::size_t i{0}; i < std::size(a); ++i) {
+			for_each_row(a[i], f, offset + i * total_items_v<std::remove_cvref_t<decltype(a[i])>>);
+		}
+	}
+}
+
+// visits the items of any array in offset order as contiguous runs: f(std::span run, std::size_t offset_of_first_item).
+// at runtime a contiguous array is a single run. during constant evaluation every innermost row is a run of its own, since pointer
+// arithmetic may not cross into the next sub-array there. mdspans with other layouts are visited one item per run. custom arrays
+// without their own for_each_run are visited through copies of up to custom_array_run_items items, so the runs are read-only.
+inline constexpr std::size_t custom_array_run_items{256};
+
+template <array A, typename F>
+constexpr void for_each_run(A& a, F&& f)
+{
+	if constexpr (custom_array_with_runs<A>) {
+		a.for_each_run(f);
+	}
+	else if constexpr (custom_array<A>) {
+		constexpr auto total{total_items_v<std::remove_cv_t<A>>};
+		std::array<remove_all_extents_t<std::remove_cv_t<A>>, std::min(total, custom_array_run_items)> buffer{};
+		for (std::size_t offset{0}; offset < total; offset += buffer.size()) {
+			const auto items{std::min(buffer.size(), total - offset)};
+			for (std::size_t i{0}; i < items; ++i) {
+				buffer[i] = a.at_offset(offset + i);
+			}
+			f(std::span{std::as_const(buffer).data(), items}, offset);
+		}
+	}
+	else if constexpr (std_mdspan<A>) {
+		if constexpr (contiguous_array<A>) {
+			if !consteval {
+				f(std::span{flat_data(a), total_items_v<std::remove_cv_t<A>>}, std::size_t{0});
+				return;
+			}
+		}
+
+		std::array<std::size_t, rank_v<A>> idx{};
+		for (std::size_t offset{0}; offset < total_items_v<std::remove_cv_t<A>>; ++offset) {
+			auto& item{std::apply([&a](auto...i) -> auto& { return a[i...]; }, idx)};
+			f(std::span{&item, 1}, offset);
+			for (std::size_t r{rank_v<A>}; r-- > 0;) {
+				if (++idx[r] < static_cast<std::size_t>(a.extent(r))) {
+					break;
+				}
+				idx[r] = 0;
+			}
+		}
+	}
+	else {
+		if !consteval {
+			f(std::span{flat_data(a), total_items_v<std::remove_cv_t<A>>}, std::size_t{0});
+			return;
+		}
+		for_each_row(a, f, 0);
+	}
+}
+
+template <array A, std::size_t R = 0>
+constexpr decltype(auto) get_item(A& a, const std::array<std::size_t, rank_v<std::remove_cv_t<A>> + R>& index)
+{
+	if constexpr (std_mdspan<A>) {
+		return std::apply([&a](auto...i) -> auto& { return a[i...]; }, index);
+	}
+	else if constexpr (custom_array_with_index<std::remove_cv_t<A>>) {
+		return a.at_index(index);
+	}
+	else if constexpr (custom_array<A>) {
+		return a.at_offset(runtime_offset_from_indexer(runtime_indexer_of_t<std::remove_cv_t<A>>{index}));
+	}
+	else if constexpr (rank_v<std::remove_cv_t<A>> == 1) {
+		return a[index[R]];
+	}
+	else {
+		return get_item<std::remove_reference_t<decltype(a[0])>, R + 1>(a[index[R]], index);
+	}
+}
+
+template <array A>
+requires (rank_v<A> > 0)
+constexpr auto get(const A& a, const runtime_indexer_of_t<A>& idx)
+{
+	return get_item(a, idx.index);
+}
+
+// --- iterators ---------------------------------------------------------------------------------------------------------------------------
+template <array A>
+struct array_iterator_data {
+	using type = std::nullptr_t;
+};
+
+template <array A>
+requires contiguous_array<A>
+struct array_iterator_data<A> {
+	using type = decltype(flat_data(std::declval<A&>()));
+};
+
+// random access iterator over the items of any array in offset order - a contiguous iterator over contiguous arrays, where it's a data
+// pointer plus an offset at runtime. dereferencing goes through at_offset during constant evaluation, and for custom arrays (whose
+// references may be proxies). indexer() converts the offset back to a runtime indexer. A may be const.
+template <array A>
+class array_iterator {
+public:
+	using value_type = remove_all_extents_t<std::remove_cv_t<A>>;
+	using reference = decltype(at_offset(std::declval<A&>(), std::size_t{0}));
+	using difference_type = std::ptrdiff_t;
+	using iterator_concept = std::conditional_t<contiguous_array<A>, std::contiguous_iterator_tag, std::random_access_iterator_tag>;
+	using iterator_category = std::conditional_t<std::is_lvalue_reference_v<reference>, std::random_access_iterator_tag,
+		std::input_iterator_tag>;
+
+	constexpr array_iterator() = default;
+
+	constexpr array_iterator(A& a, std::size_t offset)
+		: array_{&a}
+		, data_{}
+		, offset_{static_cast<difference_type>(offset)}
+	{
+		if constexpr (contiguous_array<A>) {
+			data_ = flat_data(a);
+		}
+	}
+
+	constexpr reference operator*() const
+	{
+		if constexpr (contiguous_array<A>) {
+			if !consteval {
+				return data_[offset_];
+			}
+		}
+		return at_offset(*array_, offset());
+	}
+
+	constexpr auto operator->() const
+	requires (std::is_lvalue_reference_v<reference>)
+	{
+		return std::addressof(**this);
+	}
+
+	constexpr reference operator[](difference_type n) const
+	{
+		return *(*this + n);
+	}
+
+	constexpr std::size_t offset() const
+	{
+		return static_cast<std::size_t>(offset_);
+	}
+
+	// offset must be less than the total number of items, as with runtime_indexer_from_offset.
+	constexpr runtime_indexer_of_t<std::remove_cv_t<A>> indexer() const
+	{
+		return runtime_indexer_from_offset<extents_of_t<std::remove_cv_t<A>>>(offset());
+	}
+
+	constexpr array_iterator& operator++()
+	{
+		++offset_;
+		return *this;
+	}
+
+	constexpr array_iterator operator++(int)
+	{
+		auto it{*this};
+		++offset_;
+		return it;
+	}
+
+	constexpr array_iterator& operator--()
+	{
+		--offset_;
+		return *this;
+	}
+
+	constexpr array_iterator operator--(int)
+	{
+		auto it{*this};
+		--offset_;
+		return it;
+	}
+
+	constexpr array_iterator& operator+=(difference_type n)
+	{
+		offset_ += n;
+		return *this;
+	}
+
+	constexpr array_iterator& operator-=(difference_type n)
+	{
+		offset_ -= n;
+		return *this;
+	}
+
+	friend constexpr array_iterator operator+(array_iterator it, difference_type n)
+	{
+		return it += n;
+	}
+
+	friend constexpr array_iterator operator+(difference_type n, array_iterator it)
+	{
+		return it += n;
+	}
+
+	friend constexpr array_iterator operator-(array_iterator it, difference_type n)
+	{
+		return it -= n;
+	}
+
+	friend constexpr difference_type operator-(const array_iterator& lhs, const array_iterator& rhs)
+	{
+		return lhs.offset_ - rhs.offset_;
+	}
+
+	friend constexpr bool operator==(const array_iterator& lhs, const array_iterator& rhs)
+	{
+		return lhs.offset_ == rhs.offset_;
+	}
+
+	friend constexpr auto operator<=>(const array_iterator& lhs, const array_iterator& rhs)
+	{
+		return lhs.offset_ <=> rhs.offset_;
+	}
+
+private:
+	A* array_{nullptr};
+	typename array_iterator_data<A>::type data_{nullptr};
+	difference_type offset_{0};
+};
+
+// all items of a in offset order, as a range - std::ranges algorithms (and range-for) work on any array through it.
+template <array A>
+constexpr std::ranges::subrange<array_iterator<A>> items(A& a)
+{
+	return {array_iterator<A>{a, 0}, array_iterator<A>{a, total_items_v<std::remove_cv_t<A>>}};
+}
+
+// what an enumerate_view iterator dereferences to: the runtime indexer of an item, and the item (a reference for all but proxy items).
+template <array A>
+struct enumerated_item {
+	runtime_indexer_of_t<std::remove_cv_t<A>> index;
+	typename array_iterator<A>::reference item;
+};
+
+// (runtime indexer, item) for every item of an array in offset order. the indexer is stepped along with the offset instead of being
+// recomputed, so going through the view in order costs no divisions; jumps (+=, -=, []) convert the new offset.
+template <array A>
+class enumerate_view : public std::ranges::view_interface<enumerate_view<A>> {
+public:
+	class iterator {
+	public:
+		using value_type = enumerated_item<A>;
+		using reference = enumerated_item<A>;
+		using difference_type = std::ptrdiff_t;
+		using iterator_concept = std::random_access_iterator_tag;
+		using iterator_category = std::input_iterator_tag;
+
+		constexpr iterator() = default;
+
+		constexpr iterator(A& a, std::size_t offset)
+			: it_{a, offset}
+			, idx_{index_of(offset)}
+		{
+		}
+
+		constexpr reference operator*() const
+		{
+			return {idx_, *it_};
+		}
+
+		constexpr reference operator[](difference_type n) const
+		{
+			return *(*this + n);
+		}
+
+		constexpr iterator& operator++()
+		{
+			++it_;
+			// axis 0 isn't wrapped, so the end gets {extent_v<A, 0>, 0, ...}
+			for (std::size_t r{rank}; r-- > 0;) {
+				if (++idx_.index[r] < extents[r] || r == 0) {
+					break;
+				}
+				idx_.index[r] = 0;
+			}
+			return *this;
+		}
+
+		constexpr iterator operator++(int)
+		{
+			auto it{*this};
+			++*this;
+			return it;
+		}
+
+		constexpr iterator& operator--()
+		{
+			--it_;
+			for (std::size_t r{rank}; r-- > 0;) {
+				if (idx_.index[r]-- > 0) {
+					break;
+				}
+				idx_.index[r] = extents[r] - 1;
+			}
+			return *this;
+		}
+
+		constexpr iterator operator--(int)
+		{
+			auto it{*this};
+			--*this;
+			return it;
+		}
+
+		constexpr iterator& operator+=(difference_type n)
+		{
+			it_ += n;
+			idx_ = index_of(it_.offset());
+			return *this;
+		}
+
+		constexpr iterator& operator-=(difference_type n)
+		{
+			return *this += -n;
+		}
+
+		friend constexpr iterator operator+(iterator it, difference_type n)
+		{
+			return it += n;
+		}
+
+		friend constexpr iterator operator+(difference_type n, iterator it)
+		{
+			return it += n;
+		}
+
+		friend constexpr iterator operator-(iterator it, difference_type n)
+		{
+			return it -= n;
+		}
+
+		friend constexpr difference_type operator-(const iterator& lhs, const iterator& rhs)
+		{
+			return lhs.it_ - rhs.it_;
+		}
+
+		friend constexpr bool operator==(const iterator& lhs, const iterator& rhs)
+		{
+			return lhs.it_ == rhs.it_;
+		}
+
+		friend constexpr auto operator<=>(const iterator& lhs, const iterator& rhs)
+		{
+			return lhs.it_ <=> rhs.it_;
+		}
+
+	private:
+		using indexer_t = runtime_indexer_of_t<std::remove_cv_t<A>>;
+
+		inline static constexpr std::size_t rank{rank_v<std::remove_cv_t<A>>};
+		inline static constexpr auto extents{[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+			return std::array<std::size_t, rank>{Es...};
+		}(extents_of_t<std::remove_cv_t<A>>{})};
+
+		static constexpr indexer_t index_of(std::size_t offset)
+		{
+			if (offset < total_items_v<std::remove_cv_t<A>>) {
+				return runtime_indexer_from_offset<extents_of_t<std::remove_cv_t<A>>>(offset);
+			}
+			indexer_t end{};
+			end.index[0] = extents[0];
+			return end;
+		}
+
+		array_iterator<A> it_{};
+		indexer_t idx_{};
+	};
+
+	constexpr enumerate_view() = default;
+
+	explicit constexpr enumerate_view(A& a) : array_{&a} {}
+
+	constexpr iterator begin() const
+	{
+		return {*array_, 0};
+	}
+
+	constexpr iterator end() const
+	{
+		return {*array_, total_items_v<std::remove_cv_t<A>>};
+	}
+
+private:
+	A* array_{nullptr};
+};
+
+template <array A>
+constexpr enumerate_view<A> enumerate(A& a)
+{
+	return enumerate_view<A>{a};
+}
+
 //TODO: eventually need non-const support if runtime usage should be available
 // template <valid_indexer Idx, array A>
 // requires (valid_indexer_of<A, Idx> && rank_v<A> > 0)
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "metarray.hpp"
+#include "metalgo.hpp"
+
+namespace metarray {
+
+// --- struct of arrays --------------------------------------------------------------------------------------------------------------------
+template <typename>
+struct member_pointer_traits;
+
+template <typename C, typename T>
+struct member_pointer_traits<T C::*> {
+	using class_type = C;
+	using value_type = T;
+};
+
+template <auto Field>
+using field_class_t = member_pointer_traits<decltype(Field)>::class_type;
+
+template <auto Field>
+using field_value_t = member_pointer_traits<decltype(Field)>::value_type;
+
+template <auto First, auto...>
+inline constexpr auto first_field_v{First};
+
+template <typename Soa>
+class record_ref;
+
+// records of type R (the class of the Fields member pointers) with the given extents, stored as one nested std::array per field. loops
+// that read a field or two touch only those arrays - field<&R::x>() is a plain metarray array for sum, argmin, static_find_if, etc.
+// as a whole, the container is a custom array of R: get, at_offset and friends return a record_ref, which reads or writes the fields of
+// one record in place and converts to R. members of R that aren't in Fields are value-initialized on conversion.
+template <index_sequence Extents, auto...Fields>
+requires (sizeof...(Fields) > 0 && (std::is_same_v<field_class_t<Fields>, field_class_t<first_field_v<Fields...>>> && ...))
+struct soa_array {
+	using record_type = field_class_t<first_field_v<Fields...>>;
+	using extents_type = Extents;
+	using value_type = record_type;
+
+	template <auto Field>
+	inline static constexpr std::size_t field_index_v{[] {
+		std::size_t index{sizeof...(Fields)};
+		std::size_t i{0};
+		([&] {
+			if constexpr (std::is_same_v<decltype(Field), decltype(Fields)>) {
+				index = Field == Fields && index == sizeof...(Fields) ? i : index;
+			}
+			++i;
+		}(), ...);
+		return index;
+	}()};
+
+	std::tuple<std_array_of_t<field_value_t<Fields>, Extents>...> fields;
+
+	template <auto Field>
+	requires (field_index_v<Field> < sizeof...(Fields))
+	constexpr auto& field()
+	{
+		return std::get<field_index_v<Field>>(fields);
+	}
+
+	template <auto Field>
+	requires (field_index_v<Field> < sizeof...(Fields))
+	constexpr const auto& field() const
+	{
+		return std::get<field_index_v<Field>>(fields);
+	}
+
+	constexpr record_ref<soa_array> at_offset(std::size_t offset)
+	{
+		return {*this, offset};
+	}
+
+	constexpr record_ref<const soa_array> at_offset(std::size_t offset) const
+	{
+		return {*this, offset};
+	}
+
+	constexpr record_type record(std::size_t offset) const
+	{
+		record_type result{};
+		((result.*Fields = offset_accessor(field<Fields>())(offset)), ...);
+		return result;
+	}
+
+	constexpr void assign(std::size_t offset, const record_type& record)
+	{
+		((offset_accessor(field<Fields>())(offset) = record.*Fields), ...);
+	}
+};
+
+// one record of a soa_array, by reference.
+template <typename Soa>
+class record_ref {
+public:
+	using record_type = typename std::remove_cv_t<Soa>::record_type;
+
+	constexpr record_ref(Soa& soa, std::size_t offset) : soa_{&soa}, offset_{offset} {}
+	constexpr record_ref(const record_ref&) = default;
+
+	template <auto Field>
+	constexpr auto& field() const
+	{
+		return offset_accessor(soa_->template field<Field>())(offset_);
+	}
+
+	constexpr operator record_type() const
+	{
+		return soa_->record(offset_);
+	}
+
+	constexpr const record_ref& operator=(const record_type& record) const
+	requires (not std::is_const_v<Soa>)
+	{
+		soa_->assign(offset_, record);
+		return *this;
+	}
+
+	// copies the record referred to, like assigning through a plain reference - it doesn't rebind.
+	constexpr const record_ref& operator=(const record_ref& other) const
+	requires (not std::is_const_v<Soa>)
+	{
+		soa_->assign(offset_, record_type(other));
+		return *this;
+	}
+
+private:
+	Soa* soa_;
+	std::size_t offset_;
+};
+
+// splits an array of records into a soa_array with the same extents, keeping the fields listed.
+template <auto...Fields, array A>
+requires (std::is_same_v<remove_all_extents_t<A>, field_class_t<first_field_v<Fields...>>>)
+constexpr soa_array<extents_of_t<A>, Fields...> make_soa(const A& a)
+{
+	soa_array<extents_of_t<A>, Fields...> result{};
+	for_each_run(a, [&result](auto run, std::size_t offset) {
+		for (std::size_t i{0}; i < run.size(); ++i) {
+			result.at_offset(offset + i) = run[i];
+		}
+	});
+	return result;
+}
+
+}//metarray
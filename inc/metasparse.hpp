@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "metarray.hpp"
+#include "metalgo.hpp"
+
+namespace metarray {
+
+// --- sparse arrays -----------------------------------------------------------------------------------------------------------------------
+// array with the extents of a dense one, storing only the K items that differ from fill: their offsets (ascending) and values.
+// lookups binary search the offsets - O(log K).
+template <typename T, index_sequence Extents, std::size_t K>
+struct sparse_array {
+	using extents_type = Extents;
+	using value_type = T;
+	using offset_type = least_offset_t<[]<std::size_t...Es>(const std::index_sequence<Es...>&) {
+		return (std::size_t{1} * ... * Es);
+	}(Extents{})>;
+
+	T fill;
+	std::array<offset_type, K> offsets;
+	std::array<T, K> values;
+
+	// branchless lower bound - the halving steps only depend on K, so they don't mispredict on random lookups.
+	constexpr const T& at_offset(std::size_t offset) const
+	{
+		if constexpr (K == 0) {
+			return fill;
+		}
+		else {
+			std::size_t first{0};
+			for (std::size_t n{K}; n > 1; n -= n / 2) {
+				first = offsets[first + n / 2 - 1] < offset ? first + n / 2 : first;
+			}
+			first = offsets[first] < offset ? first + 1 : first;
+			return first < K && offsets[first] == offset ? values[first] : fill;
+		}
+	}
+};
+
+template <typename T, index_sequence Extents, std::size_t K>
+constexpr auto sum(const sparse_array<T, Extents, K>& a)
+{
+	const instrument_scope<sparse_array<T, Extents, K>> instrument{"sum"};
+	// promoted like in sum(a), so narrow items don't wrap around
+	using sum_t = decltype(T{} + T{});
+	sum_t result{a.fill * static_cast<sum_t>(total_items_v<sparse_array<T, Extents, K>> - K)};
+	for (const auto& value : a.values) {
+		result += value;
+	}
+	return result;
+}
+
+// majority item of StaticArray::value (Boyer-Moore vote) - the item filling more than half of the array, if there is one. otherwise it's
+// just some item of the array, which still compresses correctly, only less.
+template <typename StaticArray>
+constexpr remove_all_extents_t<unwrap_static_array_t<StaticArray>> majority_item()
+{
+	remove_all_extents_t<unwrap_static_array_t<StaticArray>> candidate{};
+	std::size_t votes{0};
+
+	for_each_run(StaticArray::value, [&](auto run, std::size_t) {
+		for (const auto& item : run) {
+			if (votes == 0) {
+				candidate = item;
+			}
+			votes = item == candidate ? votes + 1 : votes - 1;
+		}
+	});
+	return candidate;
+}
+
+// sparse copy of StaticArray::value with the items equal to Fill (by default the majority item) left out.
+template <typename StaticArray, remove_all_extents_t<unwrap_static_array_t<StaticArray>> Fill = majority_item<StaticArray>()>
+constexpr auto compress()
+{
+	using array_t = unwrap_static_array_t<StaticArray>;
+	constexpr auto K{count_if(StaticArray::value, [](const auto& item) { return item != Fill; })};
+
+	sparse_array<remove_all_extents_t<array_t>, extents_of_t<array_t>, K> result{Fill, {}, {}};
+	using offset_t = typename decltype(result)::offset_type;
+
+	std::size_t k{0};
+	for_each_run(StaticArray::value, [&](auto run, std::size_t offset) {
+		for (std::size_t i{0}; i < run.size(); ++i) {
+			if (run[i] != Fill) {
+				result.offsets[k] = static_cast<offset_t>(offset + i);
+				result.values[k] = run[i];
+				++k;
+			}
+		}
+	});
+	return result;
+}
+
+}//metarray
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "metalgo.hpp"
+
+#if defined(METARRAY_INSTRUMENT)
+namespace metarray {
+
+// --- instrumentation stats ---------------------------------------------------------------------------------------------------------------
+// sample instrument_sink: totals per algorithm and array shape, so the hot algorithm/shape pairs stand out in dump().
+class stats_sink {
+public:
+	struct totals {
+		std::size_t calls;
+		std::size_t items;
+		std::size_t bytes;
+		std::uint64_t cycles;
+	};
+
+	// the process-wide sink that install() reports to.
+	static stats_sink& instance()
+	{
+		static stats_sink sink{};
+		return sink;
+	}
+
+	// points instrument_sink at instance().
+	static void install()
+	{
+		instrument_sink = [](const algorithm_call& call) { instance().record(call); };
+	}
+
+	void record(const algorithm_call& call)
+	{
+		const std::scoped_lock lock{mutex_};
+		auto& t{totals_[{std::string{call.algorithm}, {call.extents.begin(), call.extents.end()}}]};
+		++t.calls;
+		t.items += call.items;
+		t.bytes += call.bytes;
+		t.cycles += call.cycles;
+	}
+
+	void reset()
+	{
+		const std::scoped_lock lock{mutex_};
+		totals_.clear();
+	}
+
+	// one line per algorithm and shape, most cycles first.
+	void dump(std::ostream& os) const
+	{
+		const std::scoped_lock lock{mutex_};
+		std::vector<std::pair<key_t, totals>> rows(totals_.begin(), totals_.end());
+		std::ranges::sort(rows, std::ranges::greater{}, [](const auto& row) { return row.second.cycles; });
+
+		os << std::left << std::setw(24) << "algorithm" << std::setw(20) << "shape" << std::right << std::setw(10) << "calls"
+			<< std::setw(14) << "items" << std::setw(16) << "bytes" << std::setw(16) << "cycles" << std::setw(12) << "cycles/item" << '\n';
+		for (const auto& [key, t] : rows) {
+			std::string shape{};
+			for (const auto e : key.second) {
+				shape += (shape.empty() ? "" : "x") + std::to_string(e);
+			}
+			os << std::left << std::setw(24) << key.first << std::setw(20) << shape << std::right << std::setw(10) << t.calls
+				<< std::setw(14) << t.items << std::setw(16) << t.bytes << std::setw(16) << t.cycles << std::setw(12) << std::fixed
+				<< std::setprecision(2) << (t.items != 0 ? static_cast<double>(t.cycles) / static_cast<double>(t.items) : 0.0) << '\n';
+		}
+	}
+
+private:
+	using key_t = std::pair<std::string, std::vector<std::size_t>>;
+
+	mutable std::mutex mutex_{};
+	std::map<key_t, totals> totals_{};
+};
+
+}//metarray
+#endif
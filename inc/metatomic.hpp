@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "metarray.hpp"
+#include "metalgo.hpp"
+
+namespace metarray {
+
+// --- atomic views ------------------------------------------------------------------------------------------------------------------------
+// custom array over the items of another array, where every item is a std::atomic_ref. get<Idx>(view), get(view, runtime_indexer) and
+// view.at_offset(offset) return the atomic_ref, so threads can update a shared array in place without a lock. reading algorithms (sum,
+// argmin, ...) load each item once - the result is not a snapshot while other threads still write.
+template <array A>
+requires (std::is_trivially_copyable_v<remove_all_extents_t<A>>
+	&& std::atomic_ref<remove_all_extents_t<A>>::required_alignment == alignof(remove_all_extents_t<A>))
+class atomic_view {
+public:
+	using extents_type = extents_of_t<A>;
+	using value_type = remove_all_extents_t<A>;
+
+	explicit atomic_view(A& a) : array_{a} {}
+
+	std::atomic_ref<value_type> at_offset(std::size_t offset) const
+	{
+		return std::atomic_ref<value_type>{metarray::at_offset(array_, offset)};
+	}
+
+private:
+	A& array_;
+};
+
+// atomically item = min(item, value). returns the previous item.
+template <typename T>
+T fetch_min(std::atomic_ref<T> item, T value, std::memory_order order = std::memory_order_seq_cst)
+{
+	auto expected{item.load(std::memory_order_relaxed)};
+	while (value < expected && not item.compare_exchange_weak(expected, value, order, std::memory_order_relaxed)) {}
+	return expected;
+}
+
+// atomically item = max(item, value). returns the previous item.
+template <typename T>
+T fetch_max(std::atomic_ref<T> item, T value, std::memory_order order = std::memory_order_seq_cst)
+{
+	auto expected{item.load(std::memory_order_relaxed)};
+	while (expected < value && not item.compare_exchange_weak(expected, value, order, std::memory_order_relaxed)) {}
+	return expected;
+}
+
+template <array A>
+remove_all_extents_t<A> fetch_add(const atomic_view<A>& view, const runtime_indexer_of_t<A>& idx, remove_all_extents_t<A> value,
+	std::memory_order order = std::memory_order_seq_cst)
+{
+	return get(view, idx).fetch_add(value, order);
+}
+
+template <array A>
+remove_all_extents_t<A> fetch_min(const atomic_view<A>& view, const runtime_indexer_of_t<A>& idx, remove_all_extents_t<A> value,
+	std::memory_order order = std::memory_order_seq_cst)
+{
+	return fetch_min(get(view, idx), value, order);
+}
+
+template <array A>
+remove_all_extents_t<A> fetch_max(const atomic_view<A>& view, const runtime_indexer_of_t<A>& idx, remove_all_extents_t<A> value,
+	std::memory_order order = std::memory_order_seq_cst)
+{
+	return fetch_max(get(view, idx), value, order);
+}
+
+// --- sharded arrays ----------------------------------------------------------------------------------------------------------------------
+inline constexpr std::size_t cache_line_bytes{64};
+
+// total bytes the default shard count may spend on copies of an array. beyond that, the copies stop fitting in cache and the merge on
+// read costs more than the contention it saves.
+inline constexpr std::size_t shard_budget_bytes{std::size_t{1} << 20};
+
+// how copies of A are laid out: every shard starts on its own cache line and is padded to whole lines, so no two shards ever share one.
+// small arrays (where every update hits the same few lines) get a shard per hardware thread, large ones fewer, within shard_budget_bytes.
+template <array A>
+struct shard_policy {
+	using item_t = remove_all_extents_t<A>;
+
+	inline static constexpr std::size_t items_per_line{std::max(cache_line_bytes / sizeof(item_t), std::size_t{1})};
+	inline static constexpr std::size_t shard_items{(total_items_v<A> + items_per_line - 1) / items_per_line * items_per_line};
+	inline static constexpr std::size_t max_shards{std::max(shard_budget_bytes / (shard_items * sizeof(item_t)), std::size_t{1})};
+
+	static std::size_t default_shards()
+	{
+		return std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), max_shards);
+	}
+};
+
+// per-thread copies of an array, merged with Op on read. each shard starts out as identity, writers fold values into their own shard with
+// update(shard, ...), and at_offset (so get, sum, ... as well) folds an item across all shards. shard indices are taken modulo shards(),
+// so the worker index of parallel_for_outer can be used as is. shards are still updated atomically, since two threads may share one.
+template <array A, typename Op = std::plus<>>
+requires (std::is_trivially_copyable_v<remove_all_extents_t<A>>
+	&& std::atomic_ref<remove_all_extents_t<A>>::required_alignment == alignof(remove_all_extents_t<A>))
+class sharded_array {
+	using policy_t = shard_policy<A>;
+
+	struct alignas(cache_line_bytes) shard_t {
+		// readers of a const sharded_array still load through atomic_ref, which needs non-const items.
+		mutable std::array<remove_all_extents_t<A>, policy_t::shard_items> items;
+	};
+
+public:
+	using extents_type = extents_of_t<A>;
+	using value_type = remove_all_extents_t<A>;
+
+	explicit sharded_array(std::size_t shards = policy_t::default_shards(), value_type identity = {}, Op op = {})
+		: op_{op}
+		, shards_(std::max(shards, std::size_t{1}))
+	{
+		for (auto& shard : shards_) {
+			shard.items.fill(identity);
+		}
+	}
+
+	std::size_t shards() const
+	{
+		return shards_.size();
+	}
+
+	// shard of the calling thread, for writers that don't have a worker index.
+	std::size_t this_thread_shard() const
+	{
+		return std::hash<std::thread::id>{}(std::this_thread::get_id()) % shards_.size();
+	}
+
+	void update_offset(std::size_t shard, std::size_t offset, value_type value, std::memory_order order = std::memory_order_relaxed)
+	{
+		std::atomic_ref<value_type> item{shards_[shard % shards_.size()].items[offset]};
+		if constexpr (std::is_same_v<Op, std::plus<>> && requires { item.fetch_add(value, order); }) {
+			item.fetch_add(value, order);
+		}
+		else {
+			auto expected{item.load(std::memory_order_relaxed)};
+			while (not item.compare_exchange_weak(expected, op_(expected, value), order, std::memory_order_relaxed)) {}
+		}
+	}
+
+	void update(std::size_t shard, const runtime_indexer_of_t<A>& idx, value_type value, std::memory_order order = std::memory_order_relaxed)
+	{
+		update_offset(shard, runtime_offset_from_indexer(idx), value, order);
+	}
+
+	void update(const runtime_indexer_of_t<A>& idx, value_type value, std::memory_order order = std::memory_order_relaxed)
+	{
+		update(this_thread_shard(), idx, value, order);
+	}
+
+	// item folded across all shards.
+	value_type at_offset(std::size_t offset) const
+	{
+		auto result{load(shards_[0], offset)};
+		for (std::size_t s{1}; s < shards_.size(); ++s) {
+			result = op_(result, load(shards_[s], offset));
+		}
+		return result;
+	}
+
+	// folds all shards into a, item by item: a = op(a, merged).
+	void merge_into(A& a) const
+	{
+		auto item{offset_accessor(a)};
+		for (std::size_t offset{0}; offset < total_items_v<A>; ++offset) {
+			item(offset) = op_(item(offset), at_offset(offset));
+		}
+	}
+
+private:
+	static value_type load(const shard_t& shard, std::size_t offset)
+	{
+		return std::atomic_ref<value_type>{shard.items[offset]}.load(std::memory_order_relaxed);
+	}
+
+	Op op_;
+	std::vector<shard_t> shards_;
+};
+
+}//metarray
@@ -1,10 +1,27 @@
+#include <algorithm>
 #include <array>
+#include <cassert>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #include "metarray.hpp"
 #include "metalgo.hpp"
+#include "metasparse.hpp"
+#include "metaindex.hpp"
+#include "metatomic.hpp"
+#include "metasoa.hpp"
+#include "metapadded.hpp"
+#include "metapacked.hpp"
+#include "metacache.hpp"
+#include "metamorton.hpp"
+#include "metastats.hpp"
 // #include "demangle.hpp"
 
 namespace test {
@@ -666,6 +683,499 @@ namespace test {
 			constexpr auto result_min_a3_k7{static_transform_to_array<static_test_array_3>(min_a3_k7_sequence)};
 			static_assert(result_min_a3_k7 == std::array<int, 7>{-2, 3, 10, 11, 15, 15, 20});
 		}
+
+		{// rows of all test arrays are sorted, so the row merge picks the same items. ties are taken in offset order.
+			constexpr auto min_a1_k9{static_transform_to_array<static_test_array_1>(static_k_min_sorted_rows<9, static_test_array_1>())};
+			static_assert(min_a1_k9 == std::array<int, 9>{1, 2, 2, 3, 3, 3, 3, 4, 4});
+			static_assert(std::is_same_v<std::tuple_element_t<1, decltype(static_k_min_sorted_rows<9, static_test_array_1>())>, indexer_from_offset_t<1, extents_of_t<decltype(test_array_1)>>>);
+			static_assert(std::is_same_v<decltype(static_k_min_sorted_rows<9, static_test_array_2>()), decltype(static_find_k_min<9, static_test_array_2>())>);
+			static_assert(std::is_same_v<decltype(static_k_min_sorted_rows<7, static_test_array_3>()), decltype(static_find_k_min<7, static_test_array_3>())>);
+			static_assert(std::is_same_v<decltype(static_k_min_sorted_rows<4, static_test_array_3>()), decltype(static_find_k_min<4, static_test_array_3>())>);
+			static_assert(std::tuple_size_v<decltype(static_k_min_sorted_rows<100, static_test_array_2>())> == 12);
+
+			constexpr auto min_a3_k7{k_min_sorted_rows<7>(test_array_3)};
+			static_assert(min_a3_k7[0].index == std::array<std::size_t, 2>{2, 0});
+			static_assert(min_a3_k7[4].index == std::array<std::size_t, 2>{1, 0} && min_a3_k7[5].index == std::array<std::size_t, 2>{2, 3});
+		}
+	}
+
+	constexpr void sorted_matrix_checks()
+	{
+		static_assert(is_sorted_matrix(test_array_2));
+		static_assert(not is_sorted_matrix(test_array_3));
+
+		{// test_array_2 has no ties, so the frontier picks exactly the indexers static_find_k_min does.
+			static_assert(std::is_same_v<decltype(static_k_min_sorted_matrix<1, static_test_array_2>()), decltype(static_find_k_min<1, static_test_array_2>())>);
+			static_assert(std::is_same_v<decltype(static_k_min_sorted_matrix<9, static_test_array_2>()), decltype(static_find_k_min<9, static_test_array_2>())>);
+			static_assert(std::tuple_size_v<decltype(static_k_min_sorted_matrix<100, static_test_array_2>())> == 12);
+
+			constexpr auto min_a2_k4{k_min_sorted_matrix<4, true>(test_array_2)};
+			static_assert(min_a2_k4[3].index == std::array<std::size_t, 2>{0, 1});
+		}
+
+		{// ties are taken in offset order
+			constexpr int a[3][4]{
+				{1, 2, 2, 5},
+				{2, 2, 3, 6},
+				{2, 4, 4, 7},
+			};
+			constexpr auto min_a{k_min_sorted_matrix_offsets<7, true>(a)};
+			static_assert(min_a == std::array<std::size_t, 7>{0, 1, 2, 4, 5, 8, 6});
+			static_assert(min_a == k_min_sorted_row_offsets<7>(a));
+		}
+	}
+
+	void sorted_matrix_runtime_checks()
+	{
+		// a[r][c] grows along both axes
+		static std::array<std::array<int, 300>, 200> a{};
+		for (std::size_t r{0}; r < a.size(); ++r) {
+			for (std::size_t c{0}; c < a[r].size(); ++c) {
+				a[r][c] = static_cast<int>(r * r / 16 + c * 3 + r * c / 50);
+			}
+		}
+		assert(is_sorted_matrix(a));
+
+		assert(k_min_sorted_matrix_offsets<2000>(a) == k_min_sorted_row_offsets<2000>(a));
+		assert(k_min_sorted_matrix_offsets<1>(a)[0] == 0 && k_min_sorted_matrix_offsets<2>(a)[1] == 300);
+		[[maybe_unused]] const auto min_k{k_min_sorted_matrix<2000, true>(a)};
+		auto expected{flatten(a)};
+		std::ranges::sort(expected);
+		assert(get(a, min_k[1999]) == expected[1999]);
+
+		a[0][1] = -1;
+		[[maybe_unused]] bool thrown{false};
+		try {
+			k_min_sorted_matrix<1, true>(a);
+		}
+		catch (const std::logic_error&) {
+			thrown = true;
+		}
+		assert(thrown);
+	}
+
+	constexpr void argsort_checks()
+	{
+		// ties come in indexer_list_of_t order (axis 0 fastest), like in static_find_k_min
+		constexpr auto k_min_offsets{[]<valid_indexer...Idx>(const std::tuple<Idx...>&) {
+			return std::array{offset_from_indexer_v<Idx>...};
+		}(static_find_k_min<12, static_test_array_1>())};
+		static_assert([&] {
+			const auto order{argsort(test_array_1)};
+			return order.size() == total_items_v<decltype(test_array_1)> && std::ranges::equal(k_min_offsets, order | std::views::take(12));
+		}());
+
+		constexpr int ints[2][4]{{3, -7, 0, 3}, {-7, 2147483647, -2147483647 - 1, 0}};
+		static_assert(argsort(ints) == std::vector<std::size_t>{6, 4, 1, 2, 7, 0, 3, 5});
+
+		constexpr std::array<std::array<double, 3>, 2> doubles{{{0.5, -0.0, -2.5}, {0.0, -1e300, 1e-300}}};
+		static_assert(argsort(doubles) == std::vector<std::size_t>{4, 2, 3, 1, 5, 0});
+
+		constexpr std::array<float, 5> floats{-0.25f, 3.0f, -0.25f, -8.0f, 0.0f};
+		static_assert(argsort(floats) == std::vector<std::size_t>{3, 0, 2, 4, 1});
+
+		constexpr std::array<std::array<bool, 2>, 2> bools{{{true, false}, {false, true}}};
+		static_assert(argsort(bools) == std::vector<std::size_t>{2, 1, 0, 3});
+
+		// no radix key for 80-bit long doubles - sorted with <
+		constexpr std::array<long double, 4> longs{2.0L, -1.0L, 2.0L, -3.0L};
+		static_assert(argsort(longs) == std::vector<std::size_t>{3, 1, 0, 2});
+
+		// custom array
+		constexpr auto morton{make_morton(doubles)};
+		static_assert(argsort(morton) == argsort(doubles));
+	}
+
+	void argsort_runtime_checks()
+	{
+		// enough rows to split across workers, with lots of ties
+		static std::array<std::array<std::int32_t, 1024>, 512> ints{};
+		static std::array<std::array<double, 1024>, 512> doubles{};
+		std::uint32_t x{12345};
+		for (std::size_t r{0}; r < ints.size(); ++r) {
+			for (std::size_t c{0}; c < ints[r].size(); ++c) {
+				x = x * 1664525u + 1013904223u;
+				ints[r][c] = static_cast<std::int32_t>(x >> 12) - (1 << 19);
+				doubles[r][c] = static_cast<double>(ints[r][c] % 1000) * 0.125;
+			}
+		}
+
+		const auto check{[](const auto& a) {
+			// offsets in indexer_list_of_t order
+			std::vector<std::size_t> expected{};
+			for (std::size_t c{0}; c < a[0].size(); ++c) {
+				for (std::size_t r{0}; r < a.size(); ++r) {
+					expected.push_back(r * a[0].size() + c);
+				}
+			}
+			std::ranges::stable_sort(expected, std::less{}, [&a](std::size_t offset) { return at_offset(a, offset); });
+			assert(argsort<false>(a) == expected);
+			// the parallel split, with shares of unequal row counts too
+			for (const std::size_t workers : {2u, 3u, 8u}) {
+				parallel_workers_override = workers;
+				assert(argsort(a) == expected);
+			}
+			parallel_workers_override = 0;
+			assert(argsort(a) == expected);
+		}};
+		check(ints);
+		check(doubles);
+
+		std::vector<runtime_indexer_of_t<decltype(ints)>> idxs(10);
+		const auto order{argsort(ints)};
+		runtime_indexers_from_offsets<extents_of_t<decltype(ints)>>(std::span{order}.first(10), idxs);
+		assert(get(ints, idxs[0]) == std::ranges::min(std::span{flat_data(ints), total_items_v<decltype(ints)>}));
+	}
+
+	void find_k_runtime_checks()
+	{
+		// 256 sorted rows of 256 items
+		static std::array<std::array<std::uint16_t, 256>, 256> a{};
+		for (std::size_t r{0}; r < a.size(); ++r) {
+			for (std::size_t c{0}; c < a[r].size(); ++c) {
+				a[r][c] = static_cast<std::uint16_t>((r * 37) % 101 + c * ((r % 7) + 1));
+			}
+		}
+
+		auto expected{flatten(a)};
+		std::ranges::sort(expected);
+		const auto offsets{k_min_sorted_row_offsets<1000>(a)};
+		for (std::size_t k{0}; k < offsets.size(); ++k) {
+			assert(at_offset(a, offsets[k]) == expected[k]);
+			assert(k == 0 || at_offset(a, offsets[k - 1]) < at_offset(a, offsets[k]) || offsets[k - 1] < offsets[k]);
+		}
+
+		[[maybe_unused]] const auto min_k{k_min_sorted_rows<1000>(a)};
+		assert(get(a, min_k[999]) == expected[999]);
+	}
+
+	// 2^17 items, all generated during compilation
+	constexpr auto test_table{generate<std::array<std::array<std::uint16_t, 512>, 256>>([](std::size_t i, std::size_t j) {
+		return static_cast<std::uint16_t>((i * 512 + j) * 40503u >> 8);
+	})};
+
+	constexpr void generate_checks()
+	{
+		static_assert(generate<int[3][4]>([](std::size_t i, std::size_t j) { return static_cast<int>(i * 10 + j); })[2][3] == 23);
+		static_assert(generate<std::array<std::array<std::array<int, 5>, 3>, 2>>([](const auto& idx) {
+			return static_cast<int>(idx.index[0] * 2 + idx.index[1] + idx.index[2] + 1);
+		}) == test_array_1);
+		static_assert(generate<std::array<std::array<int, 4>, 3>>([](std::size_t offset) { return static_cast<int>(offset); })[2][1] == 9);
+		static_assert(flatten(generate<padded_array<int, std::index_sequence<3, 7>, 16>>([](std::size_t i, std::size_t j) {
+			return test_array_3[i][j];
+		})) == flatten(test_array_3));
+
+		static_assert(test_table[0][1] == 158 && test_table[255][511] == static_cast<std::uint16_t>(std::uint64_t{131071} * 40503 >> 8));
+		static_assert(test_table[100][300] == static_cast<std::uint16_t>(std::uint64_t{100 * 512 + 300} * 40503 >> 8));
+	}
+
+	constexpr void gather_checks()
+	{
+		static_assert([] {
+			constexpr std::array<std::size_t, 4> offsets{29, 0, 17, 17};
+			std::array<int, 4> out{};
+			gather(test_array_1, offsets, out);
+			return out == std::array{9, 1, 5, 5};
+		}());
+
+		static_assert([] {
+			using idx_t = runtime_indexer_of_t<decltype(test_array_3)>;
+			constexpr std::array<idx_t, 3> idxs{{{{2, 0}}, {{0, 6}}, {{2, 6}}}};
+			std::array<int, 3> out{};
+			gather(test_array_3, idxs, out);
+			return out == std::array{-2, 70, 90};
+		}());
+
+		static_assert([] {
+			auto a{test_array_1};
+			scatter(a, std::span<const std::size_t>{std::array<std::size_t, 3>{3, 5, 3}}, std::array{-1, -2, -3});
+			scatter(a, std::array{runtime_indexer_from_offset(a, 29)}, std::array{100});
+			return get<indexer_from_offset_t<3, extents_of_t<decltype(a)>>>(a) == -3 && get(a, runtime_indexer_from_offset(a, 5)) == -2
+				&& sum(a) == sum(test_array_1) - (4 + 2 + 9) + (-3 - 2 + 100);
+		}());
+
+		// custom arrays go through at_offset
+		static_assert([] {
+			auto padded{make_padded<16>(test_array_3)};
+			scatter(padded, std::array<std::size_t, 2>{0, 20}, std::array{1, 2});
+			std::array<int, 3> out{};
+			gather(padded, std::array<std::size_t, 3>{20, 1, 0}, out);
+			return out == std::array{2, 20, 1};
+		}());
+	}
+
+	void gather_runtime_checks()
+	{
+		static std::array<std::array<std::uint32_t, 1024>, 1024> a{};
+		for (std::size_t offset{0}; offset < total_items_v<decltype(a)>; ++offset) {
+			at_offset(a, offset) = static_cast<std::uint32_t>(offset);
+		}
+
+		std::vector<std::size_t> offsets(10007);
+		std::uint64_t state{11};
+		for (auto& offset : offsets) {
+			state = state * 6364136223846793005u + 1442695040888963407u;
+			offset = (state >> 33) % total_items_v<decltype(a)>;
+		}
+
+		std::vector<std::uint32_t> out(offsets.size());
+		gather(a, offsets, out);
+		for (std::size_t i{0}; i < offsets.size(); ++i) {
+			assert(out[i] == offsets[i]);
+		}
+
+		std::vector<runtime_indexer_of_t<decltype(a)>> idxs(offsets.size());
+		runtime_indexers_from_offsets<extents_of_t<decltype(a)>>(offsets, idxs);
+		std::vector<std::uint32_t> out_idx(offsets.size());
+		gather(a, idxs, out_idx);
+		assert(out_idx == out);
+
+		std::vector<std::uint32_t> values(offsets.size());
+		for (std::size_t i{0}; i < values.size(); ++i) {
+			values[i] = static_cast<std::uint32_t>(i) | 0x80000000u;
+		}
+		scatter(a, idxs, values);
+		for (std::size_t i{0}; i < offsets.size(); ++i) {
+			// repeated offsets keep the last value
+			assert(at_offset(a, offsets[i]) >= values[i] && (at_offset(a, offsets[i]) & 0x80000000u) != 0);
+		}
+		assert(at_offset(a, offsets.back()) == values.back());
+	}
+
+	constexpr void tiling_checks()
+	{
+		static_assert(std::is_same_v<tile_extents_t<int[3][4]>, std::index_sequence<3, 4>>);
+		static_assert(std::is_same_v<tile_extents_t<std::array<std::array<int, 1000>, 1000>>, std::index_sequence<64, 64>>);
+		static_assert(std::is_same_v<tile_extents_t<std::array<std::array<std::uint64_t, 1000>, 5>>, std::index_sequence<5, 32>>);
+		static_assert(std::is_same_v<tile_extents_t<int[100][100][100]>, std::index_sequence<16, 16, 16>>);
+
+		{// partial tiles along both axes
+			using tiles = std::index_sequence<2, 3>;
+			static_assert(tiled_offsets<int[3][4], tiles>() == std::array<std::size_t, 12>{0, 1, 2, 4, 5, 6, 3, 7, 8, 9, 10, 11});
+
+			constexpr auto tiled_a2{static_transform_to_array<static_test_array_2>(tiled_indexer_list_of_t<decltype(test_array_2), tiles>{})};
+			static_assert(tiled_a2 == std::array{10, 20, 30, 11, 21, 31, 40, 41, 12, 22, 32, 42});
+
+			static_assert([] {
+				std::size_t tiles_visited{0};
+				std::size_t items{0};
+				for_each_tile<tiles>(test_array_2, [&](const auto&, const auto& extents) {
+					++tiles_visited;
+					items += extents[0] * extents[1];
+				});
+				return tiles_visited == 4 && items == 12;
+			}());
+		}
+
+		{// one tile is plain offset order
+			static_assert(tiled_offsets<decltype(test_array_1)>() == [] {
+				std::array<std::size_t, 30> offsets{};
+				std::iota(offsets.begin(), offsets.end(), std::size_t{0});
+				return offsets;
+			}());
+		}
+
+		static_assert(transpose(test_array_2) == std::array<std::array<int, 3>, 4>{{
+			{10, 11, 12},
+			{20, 21, 22},
+			{30, 31, 32},
+			{40, 41, 42},
+		}});
+	}
+
+	void tiling_runtime_checks()
+	{
+		// 1000x700 ints - 16x11 tiles of 64x64, the last row and column of tiles partial
+		static std::array<std::array<int, 700>, 1000> a{};
+		for (std::size_t i{0}; i < a.size(); ++i) {
+			for (std::size_t j{0}; j < a[i].size(); ++j) {
+				a[i][j] = static_cast<int>(i * 700 + j);
+			}
+		}
+
+		[[maybe_unused]] static const auto t{transpose(a)};
+		for (std::size_t i{0}; i < a.size(); ++i) {
+			for (std::size_t j{0}; j < a[i].size(); ++j) {
+				assert(t[j][i] == a[i][j]);
+			}
+		}
+
+		const auto offsets{tiled_offsets<std::remove_cvref_t<decltype(a)>>()};
+		assert(offsets[64] == 700 && offsets[64 * 64] == 64);
+		std::vector<bool> seen(offsets.size());
+		for (const auto offset : offsets) {
+			assert(not seen[offset]);
+			seen[offset] = true;
+		}
+	}
+
+	constexpr void stencil_checks()
+	{
+		// not symmetric, so a flipped kernel or a transposed neighbourhood shows
+		constexpr int kernel[3][3]{
+			{1, 0, 2},
+			{0, 1, 0},
+			{3, 0, 1},
+		};
+
+		static_assert(std::is_same_v<stencil_extents_t<decltype(test_array_2), decltype(kernel), boundary::clamp>, std::index_sequence<3, 4>>);
+		static_assert(std::is_same_v<stencil_extents_t<decltype(test_array_2), decltype(kernel), boundary::skip>, std::index_sequence<1, 2>>);
+		// skip leaves nothing to compute when the kernel is larger than the array along any axis
+		constexpr auto has_skip_extents{[]<typename K>() {
+			return requires { typename stencil_extents_t<decltype(test_array_2), K, boundary::skip>; };
+		}};
+		static_assert(has_skip_extents.operator()<int[3][3]>() && has_skip_extents.operator()<int[3][1]>());
+		static_assert(not has_skip_extents.operator()<int[5][3]>() && not has_skip_extents.operator()<int[3][7]>());
+		static_assert(std::is_same_v<stencil_result_t<decltype(test_array_2), float[3][3], boundary::zero>, std::array<std::array<float, 4>, 3>>);
+
+		static_assert([&kernel] {
+			stencil_result_t<decltype(test_array_2), decltype(kernel), boundary::clamp> result{};
+			stencil<boundary::clamp>(test_array_2, kernel, result);
+			return result == std::array<std::array<int, 4>, 3>{{{114, 154, 234, 284}, {119, 159, 239, 289}, {123, 163, 243, 293}}};
+		}());
+		static_assert([&kernel] {
+			stencil_result_t<decltype(test_array_2), decltype(kernel), boundary::wrap> result{};
+			stencil<boundary::wrap>(test_array_2, kernel, result);
+			return result == std::array<std::array<int, 4>, 3>{{{240, 160, 240, 200}, {239, 159, 239, 199}, {235, 155, 235, 195}}};
+		}());
+		static_assert([&kernel] {
+			int result[3][4]{};
+			stencil<boundary::zero>(test_array_2, kernel, result);
+			return flatten(result) == std::array{31, 84, 134, 133, 73, 159, 239, 167, 54, 95, 135, 73};
+		}());
+		static_assert([&kernel] {
+			stencil_result_t<decltype(test_array_2), decltype(kernel), boundary::skip> result{};
+			stencil<boundary::skip>(test_array_2, kernel, result);
+			return result == std::array<std::array<int, 2>, 1>{{{159, 239}}};
+		}());
+
+		{// rank 3: a 1x3x3 box kernel sums each 3x3 neighbourhood within a slice
+			constexpr auto box{[] {
+				std::array<std::array<std::array<int, 3>, 3>, 1> k{};
+				std::ranges::fill(k[0][0], 1);
+				std::ranges::fill(k[0][1], 1);
+				std::ranges::fill(k[0][2], 1);
+				return k;
+			}()};
+			static_assert([&box] {
+				stencil_result_t<decltype(test_array_1), decltype(box), boundary::skip> result{};
+				stencil<boundary::skip>(test_array_1, box, result);
+				return result == std::array<std::array<std::array<int, 3>, 1>, 2>{{{{{27, 36, 45}}}, {{{45, 54, 63}}}}};
+			}());
+		}
+	}
+
+	template <boundary B, typename A, typename Kernel>
+	auto naive_stencil(const A& a, const Kernel& kernel)
+	{
+		static A result{};
+		const auto rows{static_cast<std::ptrdiff_t>(a.size())};
+		const auto columns{static_cast<std::ptrdiff_t>(a[0].size())};
+		for (std::ptrdiff_t i{0}; i < rows; ++i) {
+			for (std::ptrdiff_t j{0}; j < columns; ++j) {
+				float sum{0.0f};
+				for (std::ptrdiff_t di{-2}; di <= 2; ++di) {
+					for (std::ptrdiff_t dj{-2}; dj <= 2; ++dj) {
+						auto y{i + di};
+						auto x{j + dj};
+						if constexpr (B == boundary::clamp) {
+							y = std::clamp(y, std::ptrdiff_t{0}, rows - 1);
+							x = std::clamp(x, std::ptrdiff_t{0}, columns - 1);
+						}
+						else if constexpr (B == boundary::wrap) {
+							y = (y + rows) % rows;
+							x = (x + columns) % columns;
+						}
+						else if (y < 0 || y >= rows || x < 0 || x >= columns) {
+							continue;
+						}
+						sum += kernel[static_cast<std::size_t>(di + 2)][static_cast<std::size_t>(dj + 2)]
+							* a[static_cast<std::size_t>(y)][static_cast<std::size_t>(x)];
+					}
+				}
+				result[static_cast<std::size_t>(i)][static_cast<std::size_t>(j)] = sum;
+			}
+		}
+		return result;
+	}
+
+	void stencil_runtime_checks()
+	{
+		static std::array<std::array<float, 130>, 100> a{};
+		for (std::size_t i{0}; i < a.size(); ++i) {
+			for (std::size_t j{0}; j < a[i].size(); ++j) {
+				a[i][j] = static_cast<float>((i * 7 + j * 13) % 17);
+			}
+		}
+		std::array<std::array<float, 5>, 5> kernel{};
+		for (std::size_t i{0}; i < 5; ++i) {
+			for (std::size_t j{0}; j < 5; ++j) {
+				kernel[i][j] = static_cast<float>(i * 5 + j) - 12.0f;
+			}
+		}
+
+		// small integers - float sums are exact, whatever the order
+		static stencil_result_t<decltype(a), decltype(kernel), boundary::clamp> clamped{};
+		stencil<boundary::clamp>(a, kernel, clamped);
+		assert(clamped == naive_stencil<boundary::clamp>(a, kernel));
+
+		static stencil_result_t<decltype(a), decltype(kernel), boundary::wrap> wrapped{};
+		stencil<boundary::wrap>(a, kernel, wrapped);
+		assert(wrapped == naive_stencil<boundary::wrap>(a, kernel));
+
+		static stencil_result_t<decltype(a), decltype(kernel), boundary::zero> zeroed{};
+		stencil<boundary::zero>(a, kernel, zeroed);
+		[[maybe_unused]] const auto& expected{naive_stencil<boundary::zero>(a, kernel)};
+		assert(zeroed == expected);
+
+		static stencil_result_t<decltype(a), decltype(kernel), boundary::skip> skipped{};
+		stencil<boundary::skip>(a, kernel, skipped);
+		assert(skipped[0][0] == expected[2][2] && skipped[95][125] == expected[97][127]);
+	}
+
+	constexpr void reduce_many_checks()
+	{
+		constexpr auto less_5{[](int item) { return item < 5; }};
+		static_assert(reduce_many(test_array_1, sum_reducer{}, min_reducer{}, max_reducer{}, count_if_reducer{less_5})
+			== std::make_tuple(sum(test_array_1), 1, 9, std::size_t{12}));
+		static_assert(reduce_many(test_array_3, min_reducer{}) == std::make_tuple(-2));
+		static_assert(reduce_many(test_array_2, fold_reducer{0, std::bit_or<>{}}, max_reducer{})
+			== std::make_tuple(accumulate(test_array_2, 0, std::bit_or<>{}), 42));
+
+		// custom arrays run through the same loop
+		static_assert(reduce_many(make_padded<16>(test_array_3), sum_reducer{}, max_reducer{}) == std::make_tuple(sum(test_array_3), 90));
+		static_assert(std::get<0>(reduce_many(make_packed<4>(test_array_1), sum_reducer{})) == sum(test_array_1));
+
+		// no numeric_limits, no starting value for min/max
+		constexpr auto has_min_init{[]<typename T>() { return requires { min_reducer{}.init<T>(); }; }};
+		static_assert(has_min_init.operator()<int>() && has_min_init.operator()<double>());
+		static_assert(not has_min_init.operator()<std::pair<int, int>>());
+	}
+
+	void reduce_many_runtime_checks()
+	{
+		static std::array<std::array<float, 997>, 203> a{};
+		for (std::size_t i{0}; i < a.size(); ++i) {
+			for (std::size_t j{0}; j < a[i].size(); ++j) {
+				a[i][j] = static_cast<float>((i * 31 + j * 17) % 1009) - 500.0f;
+			}
+		}
+		a[100][3] = -1000.0f;
+
+		const auto [total, min, max, positive]{reduce_many(a, sum_reducer{}, min_reducer{}, max_reducer{},
+			count_if_reducer{[](float item) { return item > 0.0f; }})};
+		// small integers - the float sum is exact
+		assert(total == std::get<0>(reduce_many(a, fold_reducer{0.0f, std::plus<>{}})));
+		assert(min == -1000.0f && max == 508.0f);
+		assert(positive == count_if(a, [](float item) { return item > 0.0f; }));
+		assert(get(a, argmax(a)) == max);
+
+		static std::array<std::uint8_t, 100000> bytes{};
+		for (std::size_t i{0}; i < bytes.size(); ++i) {
+			bytes[i] = static_cast<std::uint8_t>(i % 251);
+		}
+		const auto [byte_total, byte_min, byte_max]{reduce_many(bytes, sum_reducer{}, min_reducer{}, max_reducer{})};
+		assert(byte_total == std::accumulate(bytes.begin(), bytes.end(), 0) && byte_min == 0 && byte_max == 250);
 	}
 
 	constexpr void algo_checks()
@@ -720,10 +1230,1075 @@ namespace test {
 		static_assert(sum(a4) == 150);
 		static_assert(product(a4) == 408614592055345152ull);
 	}
+
+	constexpr void counting_checks()
+	{
+		static_assert(count_if(test_array_1, [](const auto& item) { return item == 8; }) == 2);
+		static_assert(count_if(test_array_1, [](const auto& item) { return item < 5; }) == 12);
+		static_assert(count_if(test_array_3, [](const auto& item) { return item < 0; }) == 1);
+
+		static_assert(histogram(test_array_1, std::array{1, 3, 5, 10}) == std::array<std::size_t, 3>{3, 9, 18});
+		static_assert(histogram(test_array_2, std::array{0, 20, 40}) == std::array<std::size_t, 2>{3, 6});
+		static_assert(histogram(test_array_3, std::array{0, 50}) == std::array<std::size_t, 1>{11});
+
+		{// small integral fast path
+			constexpr std::array<std::array<signed char, 5>, 2> a{{{-3, -1, 0, 1, 127}, {-128, 2, 2, 2, 2}}};
+			static_assert(histogram(a, std::array<signed char, 4>{-128, -1, 2, 127}) == std::array<std::size_t, 3>{2, 3, 4});
+			static_assert(count_if(a, [](const auto& item) { return item == 2; }) == 4);
+		}
+		{// bools take the general path
+			constexpr std::array<std::array<bool, 3>, 2> a{{{true, false, true}, {false, false, true}}};
+			static_assert(histogram(a, std::array{false, true}) == std::array<std::size_t, 1>{3});
+		}
+	}
+
+	void counting_runtime_checks()
+	{
+		static std::array<std::array<unsigned char, 1000>, 300> bytes{};
+		static std::array<std::array<int, 1000>, 300> ints{};
+		for (std::size_t i{0}; i < bytes.size(); ++i) {
+			for (std::size_t j{0}; j < bytes[i].size(); ++j) {
+				bytes[i][j] = static_cast<unsigned char>((i + j) % 7);
+				ints[i][j] = static_cast<int>((i + j) % 7);
+			}
+		}
+
+		[[maybe_unused]] const auto h_bytes{histogram(bytes, std::array<unsigned char, 4>{0, 1, 3, 7})};
+		[[maybe_unused]] const auto h_ints{histogram(ints, std::array{0, 1, 3, 7})};
+		assert(h_bytes == h_ints);
+		assert(h_bytes[0] + h_bytes[1] + h_bytes[2] == total_items_v<decltype(bytes)>);
+		assert(h_bytes[0] == count_if(ints, [](int item) { return item == 0; }));
+		assert(h_bytes[1] == count_if(bytes, [](unsigned char item) { return item == 1 || item == 2; }));
+
+		// the same counts when split across workers
+		for (const std::size_t workers : {2u, 3u, 7u}) {
+			parallel_workers_override = workers;
+			assert(histogram(bytes, std::array<unsigned char, 4>{0, 1, 3, 7}) == h_bytes);
+			assert(histogram(ints, std::array{0, 1, 3, 7}) == h_ints);
+			assert(count_if(ints, [](int item) { return item == 0; }) == h_bytes[0]);
+			assert(count_if(bytes, [](unsigned char item) { return item == 1 || item == 2; }) == h_bytes[1]);
+		}
+		parallel_workers_override = 0;
+	}
+
+	constexpr void scan_checks()
+	{
+		{// 2-dim c-array
+			using result_t = std::array<std::array<int, 4>, 3>;
+			static_assert(std::is_same_v<decltype(inclusive_scan<0>(test_array_2)), result_t>);
+			static_assert(inclusive_scan<0>(test_array_2) == result_t{{{10, 20, 30, 40}, {21, 41, 61, 81}, {33, 63, 93, 123}}});
+			static_assert(inclusive_scan<1>(test_array_2) == result_t{{{10, 30, 60, 100}, {11, 32, 63, 104}, {12, 34, 66, 108}}});
+			static_assert(exclusive_scan<0>(test_array_2) == result_t{{{0, 0, 0, 0}, {10, 20, 30, 40}, {21, 41, 61, 81}}});
+			static_assert(exclusive_scan<1>(test_array_2, 1) == result_t{{{1, 11, 31, 61}, {1, 12, 33, 64}, {1, 13, 35, 67}}});
+
+			// integral image - the last item is the sum of the whole table
+			constexpr auto integral{inclusive_scan<1>(inclusive_scan<0>(test_array_2))};
+			static_assert(integral[2][3] == sum(test_array_2));
+			static_assert(integral[1][1] == 10 + 20 + 11 + 21);
+		}
+
+		{// 3-dim std::array
+			constexpr auto scan0{inclusive_scan<0>(test_array_1)};
+			static_assert(scan0[1][2] == std::array{8, 10, 12, 14, 16});
+			constexpr auto scan1{inclusive_scan<1>(test_array_1)};
+			static_assert(scan1[1][2] == std::array{12, 15, 18, 21, 24});
+			constexpr auto scan2{inclusive_scan<2>(test_array_1, std::multiplies<>{})};
+			static_assert(scan2[0][1] == std::array{2, 6, 24, 120, 720});
+			constexpr auto excl2{exclusive_scan<2>(test_array_1)};
+			static_assert(excl2[1][2] == std::array{0, 5, 11, 18, 26});
+		}
+
+		{// narrow items are promoted like in sum(a) - a uint8_t prefix sum doesn't wrap at 255
+			constexpr std::array<std::array<std::uint8_t, 4>, 2> bytes{{{200, 100, 250, 7}, {255, 255, 255, 255}}};
+			static_assert(std::is_same_v<decltype(inclusive_scan<1>(bytes)), std::array<std::array<int, 4>, 2>>);
+			static_assert(inclusive_scan<1>(bytes)[0] == std::array{200, 300, 550, 557});
+			static_assert(inclusive_scan<0>(bytes)[1] == std::array{455, 355, 505, 262});
+			static_assert(exclusive_scan<1>(bytes, 1000)[1] == std::array{1000, 1255, 1510, 1765});
+			static_assert(inclusive_scan<1>(inclusive_scan<0>(bytes))[1][3] == static_cast<int>(sum(bytes)));
+
+			// ops that keep the item type keep it in the result too
+			constexpr auto running_max{inclusive_scan<1>(bytes, [](std::uint8_t lhs, std::uint8_t rhs) { return std::max(lhs, rhs); })};
+			static_assert(std::is_same_v<decltype(running_max), const std::array<std::array<std::uint8_t, 4>, 2>>);
+			static_assert(running_max[0] == std::array<std::uint8_t, 4>{200, 200, 250, 250});
+		}
+	}
+
+	void scan_runtime_checks()
+	{
+		static std::array<std::array<long, 37>, 50> a{};
+		for (std::size_t i{0}; i < a.size(); ++i) {
+			for (std::size_t j{0}; j < a[i].size(); ++j) {
+				a[i][j] = static_cast<long>((i * 31 + j * 17) % 11) - 5;
+			}
+		}
+
+		[[maybe_unused]] const auto rows{inclusive_scan<1>(a)};
+		[[maybe_unused]] const auto cols{inclusive_scan<0>(a)};
+		[[maybe_unused]] const auto rows_excl{exclusive_scan<1>(a, 3L)};
+		for (std::size_t i{0}; i < a.size(); ++i) {
+			long row_sum{0};
+			for (std::size_t j{0}; j < a[i].size(); ++j) {
+				assert(rows_excl[i][j] == row_sum + 3);
+				row_sum += a[i][j];
+				assert(rows[i][j] == row_sum);
+				assert(cols[i][j] == (i > 0 ? cols[i - 1][j] : 0) + a[i][j]);
+			}
+		}
+
+		static std::array<std::array<std::uint8_t, 67>, 5> bytes{};
+		for (auto& row : bytes) {
+			row.fill(std::uint8_t{251});
+		}
+		[[maybe_unused]] const auto byte_rows{inclusive_scan<1>(bytes)};
+		for (std::size_t j{0}; j < bytes[0].size(); ++j) {
+			assert(byte_rows[4][j] == 251 * static_cast<int>(j + 1));
+		}
+	}
+
+	constexpr void axis_reduction_checks()
+	{
+		{// 2-dim c-array
+			static_assert(std::is_same_v<decltype(sum<0>(test_array_2)), std::array<int, 4>>);
+			static_assert(sum<0>(test_array_2) == std::array{33, 63, 93, 123});
+			static_assert(sum<1>(test_array_2) == std::array{100, 104, 108});
+			static_assert(min<0>(test_array_3) == std::array{-2, 3, 11, 15, 50, 55, 70});
+			static_assert(max<1>(test_array_3) == std::array{70, 75, 90});
+			static_assert(reduce<1>(test_array_3, 1LL, std::multiplies<>{})[1] == 15LL * 25 * 35 * 45 * 55 * 65 * 75);
+		}
+
+		{// 3-dim std::array
+			static_assert(std::is_same_v<decltype(sum<1>(test_array_1)), std::array<std::array<int, 5>, 2>>);
+			static_assert(sum<0>(test_array_1)[2] == std::array{8, 10, 12, 14, 16});
+			static_assert(sum<1>(test_array_1)[1] == std::array{12, 15, 18, 21, 24});
+			static_assert(sum<2>(test_array_1) == std::array<std::array<int, 3>, 2>{{{15, 20, 25}, {25, 30, 35}}});
+			static_assert(min<2>(test_array_1)[1] == std::array{3, 4, 5});
+			static_assert(max<0>(test_array_1)[0] == std::array{3, 4, 5, 6, 7});
+		}
+
+		{// single extent reduces to a scalar
+			constexpr std::array<int, 5> a{2, 4, 6, 8, 10};
+			static_assert(std::is_same_v<decltype(sum<0>(a)), int>);
+			static_assert(sum<0>(a) == sum(a));
+			static_assert(min<0>(a) == 2 && max<0>(a) == 10);
+		}
+
+		{// narrow items are summed like in sum(a)
+			constexpr std::uint8_t a[2][3]{{200, 100, 255}, {200, 1, 2}};
+			static_assert(std::is_same_v<decltype(sum<0>(a)), std::array<int, 3>>);
+			static_assert(sum<0>(a) == std::array{400, 101, 257} && sum<1>(a)[0] == 555);
+		}
+	}
+
+	void axis_reduction_runtime_checks()
+	{
+		static std::array<std::array<std::array<int, 45>, 20>, 10> a{};
+		for (std::size_t i{0}; i < a.size(); ++i) {
+			for (std::size_t j{0}; j < a[i].size(); ++j) {
+				for (std::size_t k{0}; k < a[i][j].size(); ++k) {
+					a[i][j][k] = static_cast<int>((i * 7 + j * 13 + k * 29) % 101) - 50;
+				}
+			}
+		}
+
+		[[maybe_unused]] const auto sum2{sum<2>(a)};
+		[[maybe_unused]] const auto min2{min<2>(a)};
+		[[maybe_unused]] const auto max1{max<1>(a)};
+		int total{0};
+		for (std::size_t i{0}; i < a.size(); ++i) {
+			for (std::size_t j{0}; j < a[i].size(); ++j) {
+				total += std::accumulate(a[i][j].begin(), a[i][j].end(), 0);
+				assert(sum2[i][j] == std::accumulate(a[i][j].begin(), a[i][j].end(), 0));
+				assert(min2[i][j] == *std::min_element(a[i][j].begin(), a[i][j].end()));
+				for (std::size_t k{0}; k < a[i][j].size(); ++k) {
+					assert(max1[i][k] >= a[i][j][k]);
+				}
+			}
+		}
+		assert(sum<0>(sum<0>(sum2)) == total);
+	}
+
+	constexpr void runtime_indexer_checks()
+	{
+		using ext_a = extents_of_t<decltype(test_array_1)>;
+		static_assert(std::is_same_v<runtime_indexer_of_t<decltype(test_array_1)>, runtime_indexer<ext_a>>);
+		static_assert(to_runtime_indexer_v<indexer_from_offset_t<17, ext_a>>.index == std::array<std::size_t, 3>{1, 0, 2});
+		static_assert(runtime_indexer_from_offset<ext_a>(17) == to_runtime_indexer_v<indexer_from_offset_t<17, ext_a>>);
+		static_assert(runtime_offset_from_indexer(runtime_indexer_from_offset<ext_a>(29)) == 29);
+		static_assert(get(test_array_1, runtime_indexer_from_offset<ext_a>(17)) == get<indexer_from_offset_t<17, ext_a>>(test_array_1));
+		static_assert(get(test_array_2, runtime_indexer_of_t<decltype(test_array_2)>{{2, 1}}) == 22);
+		static_assert(runtime_indexer_from_offset(test_array_2, 7).index == std::array<std::size_t, 2>{1, 3});
+
+		// multiply-shift division is exact over the whole bound, and only as wide as it needs to be
+		static_assert([] {
+			for (const std::uint64_t divisor : {1u, 2u, 3u, 7u, 10u, 64u, 97u, 1000u, 4095u}) {
+				const auto magic{make_divisor_magic(divisor, 1u << 20)};
+				for (std::uint64_t n{0}; n < (1u << 20); n += 1 + n / 64) {
+					if (magic.multiplier == 0 || magic.divide(n) != n / divisor) {
+						return false;
+					}
+				}
+			}
+			return true;
+		}());
+		static_assert(make_divisor_magic(64, 1u << 20).multiplier == 1 && make_divisor_magic(64, 1u << 20).shift == 6);
+
+		static_assert([] {
+			using ext = std::index_sequence<7, 11, 13>;
+			std::array<std::size_t, 7 * 11 * 13> offsets{};
+			std::array<runtime_indexer<ext>, offsets.size()> idxs{};
+			std::array<std::size_t, offsets.size()> round_trip{};
+			for (std::size_t offset{0}; offset < offsets.size(); ++offset) {
+				offsets[offset] = offset;
+			}
+			runtime_indexers_from_offsets<ext>(offsets, idxs);
+			runtime_offsets_from_indexers<ext>(idxs, round_trip);
+
+			for (std::size_t offset{0}; offset < offsets.size(); ++offset) {
+				const auto& index{idxs[offset].index};
+				if (index[0] != offset / 143 || index[1] != offset / 13 % 11 || index[2] != offset % 13 || round_trip[offset] != offset) {
+					return false;
+				}
+			}
+			return true;
+		}());
+	}
+
+	void runtime_indexer_runtime_checks()
+	{
+		// offsets past 2^32 - the outer axes need wide multipliers, or fall back to division
+		using ext = std::index_sequence<3001, 2999, 1003>;
+		std::vector<std::size_t> offsets(10000);
+		std::uint64_t state{7};
+		for (auto& offset : offsets) {
+			state = state * 6364136223846793005u + 1442695040888963407u;
+			offset = (state >> 16) % (std::size_t{3001} * 2999 * 1003);
+		}
+		offsets.back() = std::size_t{3001} * 2999 * 1003 - 1;
+
+		std::vector<runtime_indexer<ext>> idxs(offsets.size());
+		std::vector<std::size_t> round_trip(offsets.size());
+		runtime_indexers_from_offsets<ext>(offsets, idxs);
+		runtime_offsets_from_indexers<ext>(idxs, round_trip);
+		assert(round_trip == offsets);
+		for (std::size_t i{0}; i < offsets.size(); ++i) {
+			assert(idxs[i].index[2] == offsets[i] % 1003 && idxs[i].index[1] == offsets[i] / 1003 % 2999);
+		}
+		assert(idxs.back().index == (std::array<std::size_t, 3>{3000, 2998, 1002}));
+	}
+
+	constexpr void extrema_checks()
+	{
+		static_assert(argmin(test_array_1) == to_runtime_indexer_v<decltype(static_find_min<static_test_array_1>())>);
+		static_assert(argmin(test_array_2) == to_runtime_indexer_v<decltype(static_find_min<static_test_array_2>())>);
+		static_assert(argmin(test_array_3) == to_runtime_indexer_v<decltype(static_find_min<static_test_array_3>())>);
+		static_assert(get(test_array_3, argmax(test_array_3)) == 90);
+		static_assert(get(test_array_2, argmax(test_array_2)) == 42);
+
+		// ties go to the first occurrence
+		constexpr int a[2][3]{{5, 1, 9}, {1, 9, 5}};
+		static_assert(argmin(a).index == std::array<std::size_t, 2>{0, 1});
+		static_assert(argmax(a).index == std::array<std::size_t, 2>{0, 2});
+		static_assert(minmax_element(a) == std::pair{argmin(a), argmax(a)});
+	}
+
+	void extrema_runtime_checks()
+	{
+		static std::array<std::array<float, 999>, 101> a{};
+		for (std::size_t i{0}; i < a.size(); ++i) {
+			for (std::size_t j{0}; j < a[i].size(); ++j) {
+				a[i][j] = static_cast<float>((i * 131 + j * 71) % 1000);
+			}
+		}
+		a[7][300] = -1.0f;
+		a[90][5] = -1.0f;
+		a[3][998] = 5000.0f;
+		a[60][0] = 5000.0f;
+
+		const auto [min, max]{minmax_element(a)};
+		assert(min.index == (std::array<std::size_t, 2>{7, 300}));
+		assert(max.index == (std::array<std::size_t, 2>{3, 998}));
+		assert(argmin(a) == min && argmax(a) == max);
+		assert(runtime_offset_from_indexer(min) == 7 * 999 + 300);
+	}
+
+	// 2-dim std::array 32x32, mostly zeros
+	constexpr auto test_array_4{[] {
+		std::array<std::array<int, 32>, 32> a{};
+		a[0][3] = 7;
+		a[5][5] = -2;
+		a[5][6] = 9;
+		a[20][31] = 1;
+		a[31][31] = 4;
+		return a;
+	}()};
+
+	struct static_test_array_4 { constexpr static auto& value{test_array_4}; };
+
+	constexpr auto test_sparse_1{compress<static_test_array_1>()};
+
+	struct static_test_sparse_1 { constexpr static auto& value{test_sparse_1}; };
+
+	// 16x16 narrow items, the sum doesn't fit the item type
+	constexpr auto test_array_narrow{[] {
+		std::array<std::array<std::uint8_t, 16>, 16> a{};
+		for (auto& row : a) {
+			row.fill(200);
+		}
+		a[3][4] = 1;
+		return a;
+	}()};
+
+	struct static_test_array_narrow { constexpr static auto& value{test_array_narrow}; };
+
+	constexpr void sparse_checks()
+	{
+		{// mostly zeros
+			constexpr auto sparse{compress<static_test_array_4>()};
+			using sparse_t = std::remove_cvref_t<decltype(sparse)>;
+			static_assert(sparse.fill == 0 && sparse.values.size() == 5);
+			static_assert(std::is_same_v<sparse_t::offset_type, std::uint16_t>);
+			static_assert(sizeof(sparse) * 50 < sizeof(test_array_4));
+
+			static_assert(is_array_v<sparse_t>);
+			static_assert(rank_v<sparse_t> == 2);
+			static_assert(std::is_same_v<extents_of_t<sparse_t>, extents_of_t<decltype(test_array_4)>>);
+			static_assert(total_items_v<sparse_t> == 32*32);
+
+			using ext_a = extents_of_t<decltype(test_array_4)>;
+			static_assert(get<indexer_from_offset_t<5*32 + 6, ext_a>>(sparse) == 9);
+			static_assert(get<indexer_from_offset_t<5*32 + 7, ext_a>>(sparse) == 0);
+			static_assert(get(sparse, runtime_indexer_of_t<sparse_t>{{31, 31}}) == 4);
+			static_assert(sum(sparse) == 19);
+			static_assert(argmin(sparse) == argmin(test_array_4));
+			static_assert(count_if(sparse, [](const auto& item) { return item > 0; }) == 4);
+
+			// 1024 items - far past the template depth the per-item recursion of static_find_if used to need.
+			using found_9 = decltype(static_find_if<static_test_array_4>([](const auto& item) constexpr { return item == 9; } ));
+			static_assert(std::is_same_v<found_9, std::tuple<indexer_from_offset_t<5*32 + 6, ext_a>>>);
+			using found_non_zero = decltype(static_find_if<static_test_array_4>([](const auto& item) constexpr { return item != 0; } ));
+			static_assert(std::tuple_size_v<found_non_zero> == 5);
+		}
+
+		{// repeated default value, every item matches the dense array
+			static_assert(test_sparse_1.fill == majority_item<static_test_array_1>());
+			static_assert(test_sparse_1.values.size() == count_if(test_array_1, [](const auto& item) { return item != test_sparse_1.fill; }));
+			static_assert(sum(test_sparse_1) == sum(test_array_1));
+			static_assert(flatten(test_sparse_1) == flatten(test_array_1));
+
+			using found_8 = decltype(static_find_if<static_test_sparse_1>([](const auto& item) constexpr { return item == 8; } ));
+			static_assert(std::is_same_v<found_8, decltype(static_find_if<static_test_array_1>([](const auto& item) constexpr { return item == 8; } ))>);
+			static_assert(std::is_same_v<decltype(static_find_min<static_test_sparse_1>()), decltype(static_find_min<static_test_array_1>())>);
+		}
+
+		{// explicit fill
+			constexpr auto sparse{compress<static_test_array_2, 10>()};
+			static_assert(sparse.values.size() == 11);
+			static_assert(flatten(sparse) == flatten(test_array_2));
+		}
+
+		{// narrow items - sum is promoted like the dense one
+			constexpr auto sparse{compress<static_test_array_narrow>()};
+			static_assert(sparse.fill == 200 && sparse.values.size() == 1);
+			static_assert(std::is_same_v<decltype(sum(sparse)), decltype(sum(test_array_narrow))>);
+			static_assert(sum(sparse) == 255 * 200 + 1 && sum(sparse) == sum(test_array_narrow));
+		}
+	}
+
+	constexpr double test_array_5[2][3]{
+		{0.5, -0.0, 1.5},
+		{0.0, 0.5, 2.5},
+	};
+
+	struct static_test_array_5 { constexpr static auto& value{test_array_5}; };
+
+	constexpr void index_checks()
+	{
+		{
+			constexpr auto index{index_values<static_test_array_1>()};
+			using index_t = std::remove_cvref_t<decltype(index)>;
+			static_assert(std::is_same_v<index_t::offset_type, std::uint8_t>);
+			static_assert(std::ranges::equal(index.find(8), std::array{24, 28}));
+			static_assert(std::ranges::equal(index.find(5), std::array{4, 8, 12, 17, 21, 25}));
+			static_assert(index.find(0).empty() && not index.contains(10) && index.contains(1));
+
+			// each offset is listed exactly once, under its own item.
+			static_assert([&index] {
+				std::size_t found{0};
+				for (std::size_t offset{0}; offset < total_items_v<decltype(test_array_1)>; ++offset) {
+					const auto offsets{index.find(at_offset(test_array_1, offset))};
+					found += static_cast<std::size_t>(std::ranges::count(offsets, offset));
+				}
+				return found;
+			}() == total_items_v<decltype(test_array_1)>);
+
+			constexpr auto idx{runtime_indexer_from_offset<extents_of_t<decltype(test_array_1)>>(index.find(9)[0])};
+			static_assert(idx.index == std::array<std::size_t, 3>{1, 2, 4});
+		}
+
+		{// mostly zeros
+			constexpr auto index{index_values<static_test_array_4>()};
+			static_assert(index.count(0) == 32*32 - 5);
+			static_assert(std::ranges::equal(index.find(9), std::array{5*32 + 6}));
+			static_assert(std::is_same_v<std::remove_cvref_t<decltype(index)>::offset_type, std::uint16_t>);
+		}
+
+		{// -0.0 == 0.0
+			constexpr auto index{index_values<static_test_array_5>()};
+			static_assert(std::ranges::equal(index.find(0.0), std::array{1, 3}));
+			static_assert(std::ranges::equal(index.find(-0.0), std::array{1, 3}));
+			static_assert(std::ranges::equal(index.find(0.5), std::array{0, 4}));
+			static_assert(not index.contains(1.0));
+		}
+	}
+
+	struct particle {
+		float x;
+		float y;
+		int id;
+		double mass;
+
+		constexpr bool operator==(const particle&) const = default;
+	};
+
+	constexpr auto test_particles{[] {
+		std::array<std::array<particle, 4>, 3> a{};
+		for (std::size_t i{0}; i < 3; ++i) {
+			for (std::size_t j{0}; j < 4; ++j) {
+				const auto n{static_cast<int>(i * 4 + j)};
+				a[i][j] = {static_cast<float>(n) * 0.5f, static_cast<float>(12 - n), n, 1.0};
+			}
+		}
+		return a;
+	}()};
+
+	constexpr auto test_soa_1{make_soa<&particle::x, &particle::y, &particle::id>(test_particles)};
+
+	struct static_test_soa_1_y { constexpr static auto& value{test_soa_1.field<&particle::y>()}; };
+
+	constexpr void soa_checks()
+	{
+		using soa_t = std::remove_cvref_t<decltype(test_soa_1)>;
+		static_assert(is_array_v<soa_t> && rank_v<soa_t> == 2 && total_items_v<soa_t> == 12);
+		static_assert(std::is_same_v<extents_of_t<soa_t>, extents_of_t<decltype(test_particles)>>);
+		static_assert(std::is_same_v<remove_all_extents_t<soa_t>, particle>);
+		static_assert(std::is_same_v<std::remove_cvref_t<decltype(test_soa_1.field<&particle::id>())>, std::array<std::array<int, 4>, 3>>);
+
+		// field views are plain arrays
+		static_assert(sum(test_soa_1.field<&particle::id>()) == 66);
+		static_assert(argmin(test_soa_1.field<&particle::y>()).index == std::array<std::size_t, 2>{2, 3});
+		static_assert(count_if(test_soa_1.field<&particle::x>(), [](float x) { return x >= 3.0f; }) == 6);
+		using found_y_1 = decltype(static_find_if<static_test_soa_1_y>([](float y) constexpr { return y == 1.0f; }));
+		static_assert(std::is_same_v<found_y_1, std::tuple<indexer_from_offset_t<11, extents_of_t<soa_t>>>>);
+
+		// records come back through proxies - mass isn't stored
+		static_assert(get(test_soa_1, {{1, 2}}) == particle{3.0f, 6.0f, 6, 0.0});
+		static_assert(get<indexer_from_offset_t<5, extents_of_t<soa_t>>>(test_soa_1).field<&particle::id>() == 5);
+		static_assert(static_cast<particle>(test_soa_1.at_offset(11)).y == 1.0f);
+
+		static_assert([] {
+			auto soa{make_soa<&particle::id, &particle::mass>(test_particles)};
+			soa.at_offset(3) = particle{0.0f, 0.0f, 100, 2.5};
+			soa.at_offset(8).field<&particle::mass>() = 4.0;
+			return sum(soa.field<&particle::id>()) == 66 - 3 + 100 && sum(soa.field<&particle::mass>()) == 12.0 + 1.5 + 3.0;
+		}());
+
+		static_assert([] {
+			auto soa{make_soa<&particle::id, &particle::mass>(test_particles)};
+			const auto first{soa.at_offset(0)};
+			first = soa.at_offset(11);
+			soa.at_offset(1) = first;
+			return soa.at_offset(0).field<&particle::id>() == 11 && soa.at_offset(1).field<&particle::id>() == 11
+				&& soa.at_offset(11).field<&particle::id>() == 11 && sum(soa.field<&particle::id>()) == 66 - 0 - 1 + 22;
+		}());
+
+		static_assert(flatten(make_soa<&particle::x, &particle::y, &particle::id, &particle::mass>(test_particles)) == flatten(test_particles));
+	}
+
+	constexpr void cached_checks()
+	{
+		static_assert([] {
+			int a[3][4]{};
+			for (std::size_t offset{0}; offset < 12; ++offset) {
+				at_offset(a, offset) = at_offset(test_array_2, offset);
+			}
+			cached_array<decltype(a), cached::all> c{a};
+			const bool before{c.sum() == sum(test_array_2) && c.count() == 12 && c.min() == 10 && c.max() == 42
+				&& std::ranges::equal(c.axis_sums<0>(), sum<1>(test_array_2)) && std::ranges::equal(c.axis_sums<1>(), sum<0>(test_array_2))};
+
+			c.set<indexer_from_offset_t<5, extents_of_t<decltype(a)>>>(0);// 21
+			c.set(runtime_indexer_of_t<decltype(a)>{{2, 3}}, 50);// 42, the max
+			c.set(0, 5);// 10, the min
+			return before && sum(c) == sum(a) && c.count() == 11 && c.min() == 0 && c.max() == 50 && get(c, {{1, 1}}) == 0
+				&& std::ranges::equal(c.axis_sums<0>(), sum<1>(a)) && std::ranges::equal(c.axis_sums<1>(), sum<0>(a));
+		}());
+
+		static_assert([] {
+			auto a{test_array_1};
+			cached_array<decltype(a), cached::min | cached::max> c{a};
+			const bool before{c.min() == 1 && c.max() == 9};
+			// overwriting the only min and max with something in between drops both - the next query rescans
+			c.set(0, 5);
+			c.set(29, 5);
+			const bool rescanned{c.min() == 2 && c.max() == 8};
+			c.set<indexer_from_offset_t<7, extents_of_t<decltype(a)>>>(-1);
+			return before && rescanned && c.min() == -1 && c.max() == 8;
+		}());
+
+		static_assert([] {
+			auto a{test_array_1};
+			cached_array<decltype(a), cached::sum | cached::count, decltype([](int item) { return item % 2 == 0; })> c{a};
+			c.set(0, 2);
+			c.set(1, 3);
+			return c.sum() == sum(test_array_1) + 2 && c.count() == count_if(a, [](int item) { return item % 2 == 0; });
+		}());
+	}
+
+	void cached_runtime_checks()
+	{
+		static std::array<std::array<std::array<double, 60>, 40>, 20> a{};
+		for (std::size_t offset{0}; offset < total_items_v<decltype(a)>; ++offset) {
+			at_offset(a, offset) = static_cast<double>(offset % 97);
+		}
+
+		cached_array<decltype(a), cached::all, std::function<bool(double)>> c{a, [](double item) { return item > 50.0; }};
+		std::uint32_t state{12345};
+		for (std::size_t i{0}; i < 20000; ++i) {
+			state = state * 1664525u + 1013904223u;
+			// small integers - the sums stay exact
+			c.set(state % total_items_v<decltype(a)>, static_cast<double>(state >> 20 & 255) - 100.0);
+			if (i % 1000 == 0) {
+				const auto [total, min, max, over_50]{reduce_many(a, sum_reducer{}, min_reducer{}, max_reducer{},
+					count_if_reducer{[](double item) { return item > 50.0; }})};
+				assert(c.sum() == total && c.min() == min && c.max() == max && c.count() == over_50);
+			}
+		}
+		assert(std::ranges::equal(c.axis_sums<2>(), sum<0>(sum<0>(a))));
+		assert(std::ranges::equal(c.axis_sums<0>(), sum<1>(sum<1>(a))));
+	}
+
+	constexpr void morton_checks()
+	{
+		using layout_4x4 = morton_layout<std::index_sequence<4, 4>>;
+		static_assert(layout_4x4::masks == std::array<std::uint64_t, 2>{0b1010, 0b0101} && layout_4x4::size == 16);
+		static_assert(layout_4x4::encode({1, 0}) == 2 && layout_4x4::encode({2, 3}) == 13 && layout_4x4::decode(13) == std::array<std::size_t, 2>{2, 3});
+		static_assert(layout_4x4::next<1>(layout_4x4::encode({2, 1})) == layout_4x4::encode({2, 2}));
+		static_assert(layout_4x4::next<0>(layout_4x4::encode({1, 3})) == layout_4x4::encode({2, 3}));
+
+		// the longer axis keeps its upper bits to itself
+		using layout_3x7 = morton_layout<extents_of_t<decltype(test_array_3)>>;
+		static_assert(layout_3x7::masks == std::array<std::uint64_t, 2>{0b01010, 0b10101} && layout_3x7::size == 32);
+		static_assert(deposit_bits(0b101, 0b110100) == 0b100100 && extract_bits(0b100100, 0b110100) == 0b101);
+		// one past a power of 2 doubles the storage along every axis
+		static_assert(morton_layout<std::index_sequence<128, 128, 128>>::size == 128 * 128 * 128);
+		static_assert(morton_layout<std::index_sequence<129, 129, 129>>::size == 256 * 256 * 256);
+
+		constexpr auto morton_3{make_morton(test_array_3)};
+		static_assert(std::is_same_v<extents_of_t<decltype(morton_3)>, extents_of_t<decltype(test_array_3)>>);
+		static_assert(get<indexer_from_offset_t<16, extents_of_t<decltype(morton_3)>>>(morton_3) == 11);
+		static_assert(get(morton_3, runtime_indexer_of_t<decltype(morton_3)>{{1, 6}}) == 75);
+		static_assert(flatten(morton_3) == flatten(test_array_3));
+		static_assert(to_row_major(morton_3) == std::to_array({std::to_array(test_array_3[0]), std::to_array(test_array_3[1]),
+			std::to_array(test_array_3[2])}));
+		static_assert(sum(morton_3) == sum(test_array_3) && argmin(morton_3) == argmin(test_array_3));
+
+		static_assert(to_row_major(make_morton(test_array_1)) == test_array_1);
+	}
+
+	void morton_runtime_checks()
+	{
+		static std::array<std::array<std::array<std::uint32_t, 40>, 33>, 17> a{};
+		for (std::size_t offset{0}; offset < total_items_v<decltype(a)>; ++offset) {
+			at_offset(a, offset) = static_cast<std::uint32_t>(offset * 2654435761u);
+		}
+
+		static auto m{make_morton(a)};
+		assert(to_row_major(m) == a);
+		for (std::size_t offset{0}; offset < total_items_v<decltype(a)>; offset += 7) {
+			[[maybe_unused]] const auto idx{runtime_indexer_from_offset(a, offset)};
+			assert(get(m, idx) == get(a, idx) && m.at_offset(offset) == at_offset(a, offset));
+			assert(decltype(m)::layout::decode(decltype(m)::layout::encode(idx.index)) == idx.index);
+		}
+
+		get_item(m, std::array<std::size_t, 3>{16, 32, 39}) = 5;
+		assert(to_row_major(m)[16][32][39] == 5);
+	}
+
+	constexpr auto test_morton_3{make_morton(test_array_3)};
+
+	constexpr void iterator_checks()
+	{
+		using it_t = array_iterator<const std::remove_cvref_t<decltype(test_array_1)>>;
+		static_assert(std::contiguous_iterator<it_t> && std::contiguous_iterator<array_iterator<int[3][4]>>);
+		static_assert(std::random_access_iterator<array_iterator<const morton_array<int, std::index_sequence<3, 4>>>>);
+		static_assert(std::random_access_iterator<array_iterator<packed_array<2, std::index_sequence<5, 7>>>>);
+		static_assert(std::ranges::contiguous_range<decltype(items(test_array_2))>);
+		static_assert(std::ranges::random_access_range<enumerate_view<const int[3][4]>>);
+		static_assert(std::ranges::view<enumerate_view<const int[3][4]>>);
+
+		static_assert(std::ranges::distance(items(test_array_1)) == 30);
+		static_assert(std::accumulate(items(test_array_1).begin(), items(test_array_1).end(), 0) == sum(test_array_1));
+		static_assert(std::ranges::max_element(items(test_array_3)).indexer() == argmax(test_array_3));
+		static_assert(std::ranges::count(items(test_array_3), 55) == 2);
+		static_assert(items(test_array_2)[5] == 21 && *(items(test_array_2).end() - 1) == 42);
+		static_assert(std::ranges::equal(items(test_array_3), flatten(test_array_3)));
+		static_assert(std::ranges::equal(items(test_morton_3), items(test_array_3)));
+
+		// across rows
+		static_assert([] {
+			auto a{copy_to_std_array(test_array_3)};
+			std::ranges::sort(items(a));
+			return std::ranges::is_sorted(items(a)) && a[0][0] == -2 && a[2][6] == 90 && sum(a) == sum(test_array_3);
+		}());
+
+		// indexers along with the items, forwards and backwards
+		static_assert([] {
+			for (const auto [idx, item] : enumerate(test_array_1)) {
+				if (get(test_array_1, idx) != item) {
+					return false;
+				}
+			}
+			std::size_t offset{total_items_v<decltype(test_array_1)>};
+			for (const auto [idx, item] : enumerate(test_array_1) | std::views::reverse) {
+				if (idx != runtime_indexer_from_offset(test_array_1, --offset) || at_offset(test_array_1, offset) != item) {
+					return false;
+				}
+			}
+			const auto view{enumerate(test_array_1)};
+			const auto it{view.begin() + 17};
+			return offset == 0 && (*it).index == runtime_indexer_from_offset(test_array_1, 17) && it[-2].item == at_offset(test_array_1, 15)
+				&& view.end() - it == 13 && (*(view.end() - 1)).index == runtime_indexer_of_t<decltype(test_array_1)>{{1, 2, 4}};
+		}());
+
+		// writes go through
+		static_assert([] {
+			std::array<std::array<int, 4>, 3> a{};
+			for (auto [idx, item] : enumerate(a)) {
+				item = static_cast<int>(idx.index[0] * 10 + idx.index[1]);
+			}
+			packed_array<2, std::index_sequence<5, 7>> p{};
+			*(items(p).begin() + 9) = 3;
+			return a[2][3] == 23 && a[1][0] == 10 && p.at_offset(9) == 3 && sum(p) == 3;
+		}());
+	}
+
+	void iterator_runtime_checks()
+	{
+		static std::array<std::array<std::int64_t, 1000>, 300> a{};
+		for (auto [idx, item] : enumerate(a)) {
+			item = static_cast<std::int64_t>(idx.index[0] * 7919 + idx.index[1] * 104729) % 1009;
+		}
+		assert(std::to_address(items(a).begin() + 1500) == &a[1][500]);
+		assert(std::ranges::max_element(items(a)).indexer() == argmax(a));
+		const auto flat{std::span{flat_data(a), total_items_v<decltype(a)>}};
+		assert(std::accumulate(items(a).begin(), items(a).end(), std::int64_t{0}) == std::accumulate(flat.begin(), flat.end(), std::int64_t{0}));
+
+		std::ranges::sort(items(a), std::ranges::greater{});
+		assert(std::ranges::is_sorted(items(a), std::ranges::greater{}) && a[0][0] == 1008);
+
+		// packed items are proxies: assigning one to another copies the item
+		static std::array<std::array<std::uint8_t, 1000>, 30> codes{};
+		for (auto [idx, item] : enumerate(codes)) {
+			item = static_cast<std::uint8_t>((idx.index[0] * 5 + idx.index[1] * 3) % 7 % 4);
+		}
+		static const auto q{make_packed<2>(codes)};
+		static packed_array<2, extents_of_t<decltype(codes)>> p{};
+		std::ranges::copy(items(q), items(p).begin());
+		assert(flatten(p) == flatten(q) && flatten(p) == flatten(codes));
+		std::ranges::copy(items(p).begin() + 1, items(p).end(), items(p).begin());
+		assert(p.at_offset(0) == q.at_offset(1) && p.at_offset(29998) == q.at_offset(29999) && p.at_offset(29999) == q.at_offset(29999));
+	}
+
+	constexpr auto test_padded_3{make_padded<16>(test_array_3)};
+
+	struct static_test_padded_3 { constexpr static auto& value{test_padded_3}; };
+
+	constexpr void padded_checks()
+	{
+		constexpr auto& padded{test_padded_3};
+		using padded_t = std::remove_cvref_t<decltype(padded)>;
+		static_assert(is_array_v<padded_t> && rank_v<padded_t> == 2);
+		static_assert(std::is_same_v<extents_of_t<padded_t>, extents_of_t<decltype(test_array_3)>>);
+		static_assert(extent_v<padded_t, 1> == 7 && total_items_v<padded_t> == 21);
+		static_assert(padded_t::row_stride == 8 && padded_t::row_lanes == std::min(simd_lanes_v<int>, std::size_t{8}) && alignof(padded_t) == 16);
+		static_assert(sizeof(padded) == 3 * 8 * sizeof(int));
+
+		static_assert(get(padded, {{2, 6}}) == 90 && get<indexer_from_offset_t<7, extents_of_t<padded_t>>>(padded) == 15);
+		static_assert(flatten(padded) == flatten(test_array_3));
+		static_assert(sum(padded) == sum(test_array_3));
+		static_assert(count_if(padded, [](int item) { return item < 20; }) == 6);
+		static_assert(count_if(padded, [](int item) { return item > 50; }) == 8);
+		static_assert(argmin(padded) == argmin(test_array_3));
+		static_assert(minmax_element(padded) == minmax_element(test_array_3));
+
+		// the padding is 0, so every kernel has to mask it out of these
+		constexpr auto non_positive{[](int item) { return item <= 0; }};
+		static_assert(reduce_many(padded, max_reducer{}, count_if_reducer{non_positive}) == std::make_tuple(90, std::size_t{1}));
+		static_assert(count_if(padded, non_positive) == 1);
+		static_assert(histogram(padded, std::array{-10, 0, 20, 100}) == histogram(test_array_3, std::array{-10, 0, 20, 100}));
+		static_assert(sum<0>(padded) == sum<0>(test_array_3) && sum<1>(padded) == sum<1>(test_array_3));
+		static_assert(min<1>(padded) == min<1>(test_array_3) && max<0>(padded) == max<0>(test_array_3));
+
+		static_assert(padded.padded_row(1)[0] == 15 && padded.padded_row(1)[7] == 0);
+
+		using found_15 = decltype(static_find_if<static_test_padded_3>([](const auto& item) constexpr { return item == 15; }));
+		static_assert(std::is_same_v<found_15, decltype(static_find_if<static_test_array_3>([](const auto& item) constexpr { return item == 15; }))>);
+	}
+
+	void padded_runtime_checks()
+	{
+		static padded_array<std::uint8_t, std::index_sequence<300, 77>, 64> a{};
+		static std::array<std::array<std::uint8_t, 77>, 300> dense{};
+		static_assert(decltype(a)::row_stride == 128 && alignof(decltype(a)) == 64);
+		std::size_t expected_sum{0};
+		std::size_t expected_odd{0};
+		for (std::size_t offset{0}; offset < total_items_v<decltype(a)>; ++offset) {
+			a.at_offset(offset) = static_cast<std::uint8_t>(offset * 7 % 251);
+			at_offset(dense, offset) = a.at_offset(offset);
+			expected_sum += offset * 7 % 251;
+			expected_odd += offset * 7 % 251 % 2;
+		}
+		assert(static_cast<std::size_t>(sum(a)) == expected_sum);
+		assert(count_if(a, [](std::uint8_t item) { return item % 2 == 1; }) == expected_odd);
+		assert(count_if(a, [](std::uint8_t item) { return item % 2 == 0; }) == 300 * 77 - expected_odd);
+		assert(reinterpret_cast<std::uintptr_t>(a.padded_row(5).data()) % 64 == 0);
+
+		assert(minmax_element(a) == minmax_element(dense));
+		assert(reduce_many(a, min_reducer{}, max_reducer{}, count_if_reducer{[](std::uint8_t item) { return item < 10; }})
+			== reduce_many(dense, min_reducer{}, max_reducer{}, count_if_reducer{[](std::uint8_t item) { return item < 10; }}));
+		assert(histogram(a, std::array<std::uint8_t, 4>{0, 1, 100, 255}) == histogram(dense, std::array<std::uint8_t, 4>{0, 1, 100, 255}));
+		assert(sum<0>(a) == sum<0>(dense) && sum<1>(a) == sum<1>(dense));
+		assert(min<1>(a) == min<1>(dense) && max<0>(a) == max<0>(dense));
+	}
+
+	// 10x13 flags, set on the diagonals (they cross at [6][6])
+	constexpr auto test_flags{[] {
+		std::array<std::array<bool, 13>, 10> a{};
+		for (std::size_t i{0}; i < 10; ++i) {
+			a[i][i] = true;
+			a[i][12 - i] = true;
+		}
+		return a;
+	}()};
+
+	constexpr void packed_checks()
+	{
+		{// flags
+			constexpr auto flags{make_packed<1>(test_flags)};
+			using flags_t = std::remove_cvref_t<decltype(flags)>;
+			static_assert(is_array_v<flags_t> && rank_v<flags_t> == 2 && extent_v<flags_t, 1> == 13 && total_items_v<flags_t> == 130);
+			static_assert(std::is_same_v<remove_all_extents_t<flags_t>, bool>);
+			static_assert(sizeof(flags) == 3 * sizeof(std::uint64_t) && sizeof(test_flags) == 130);
+
+			static_assert(flatten(flags) == flatten(test_flags));
+			static_assert(get(flags, {{3, 9}}) && not get(flags, {{3, 8}}));
+			static_assert(sum(flags) == 19 && count(flags, true) == 19 && count(flags, false) == 111);
+			static_assert(find(flags, true)->index == std::array<std::size_t, 2>{0, 0});
+			static_assert(find(flags, false)->index == std::array<std::size_t, 2>{0, 1});
+			static_assert(min(flags) == false && max(flags) == true);
+		}
+
+		{// 4-bit codes
+			constexpr auto codes{make_packed<4>(test_array_1)};
+			static_assert(flatten(codes) == [] {
+				std::array<std::uint8_t, 30> items{};
+				std::ranges::transform(flatten(test_array_1), items.begin(), [](int item) { return static_cast<std::uint8_t>(item); });
+				return items;
+			}());
+			static_assert(sum(codes) == static_cast<std::size_t>(sum(test_array_1)));
+			static_assert(count(codes, std::uint8_t{5}) == 6 && count(codes, std::uint8_t{0}) == 0);
+			static_assert(find(codes, std::uint8_t{8})->index == std::array<std::size_t, 3>{1, 1, 4});
+			static_assert(not find(codes, std::uint8_t{12}).has_value());
+			static_assert(min(codes) == 1 && max(codes) == 9);
+			static_assert(argmax(codes) == argmax(test_array_1));
+		}
+
+		{// writes through the proxy, 2-bit codes
+			static_assert([] {
+				packed_array<2, std::index_sequence<5, 7>> a{};
+				a.at_offset(34) = 3;
+				get_item(a, std::array<std::size_t, 2>{2, 2}) = 2;
+				a.at_offset(20) = 1;
+				return get(a, {{2, 2}}) == 2 && sum(a) == 6 && count(a, std::uint8_t{0}) == 32 && min(a) == 0 && max(a) == 3
+					&& find(a, std::uint8_t{3})->index == std::array<std::size_t, 2>{4, 6};
+			}());
+
+			// proxy to proxy copies the item, in the same word and across words
+			static_assert([] {
+				packed_array<2, std::index_sequence<5, 7>> a{};
+				a.at_offset(2) = 3;
+				a.at_offset(30) = 2;
+				a.at_offset(1) = a.at_offset(2);
+				const auto r{a.at_offset(33)};
+				r = a.at_offset(30);
+				return a.at_offset(1) == 3 && a.at_offset(2) == 3 && a.at_offset(33) == 2 && a.at_offset(30) == 2 && sum(a) == 10;
+			}());
+		}
+	}
+
+	void packed_runtime_checks()
+	{
+		static std::array<std::array<std::uint8_t, 1000>, 333> a{};
+		for (std::size_t i{0}; i < a.size(); ++i) {
+			for (std::size_t j{0}; j < a[i].size(); ++j) {
+				a[i][j] = static_cast<std::uint8_t>(1 + (i * 7 + j * 3) % 13 % 3);
+			}
+		}
+		[[maybe_unused]] static const auto packed{make_packed<2>(a)};
+
+		[[maybe_unused]] const auto total{[&] {
+			std::size_t result{0};
+			for_each_run(a, [&result](auto run, std::size_t) {
+				for (const auto item : run) {
+					result += item;
+				}
+			});
+			return result;
+		}()};
+		assert(sum(packed) == total);
+		assert(count(packed, std::uint8_t{2}) == count_if(a, [](std::uint8_t item) { return item == 2; }));
+		assert(min(packed) == 1 && max(packed) == 3 && not find(packed, std::uint8_t{0}));
+		assert(flatten(packed) == flatten(a));
+
+		// probes that don't fit in 2 bits must not alias to 0 - neither the zeros nor the unused slots of the last word
+		static_assert(decltype(packed)::total % decltype(packed)::items_per_word != 0);
+		assert(count(packed, std::uint8_t{4}) == 0 && not find(packed, std::uint8_t{4}));
+		const std::array<std::uint8_t, 5> zeros{0, 3, 0, 1, 0};
+		[[maybe_unused]] const auto packed_zeros{make_packed<2>(zeros)};
+		assert(count(packed_zeros, std::uint8_t{0}) == 3 && count(packed_zeros, std::uint8_t{8}) == 0);
+		assert(not find(packed_zeros, std::uint8_t{12}) && find(packed_zeros, std::uint8_t{3})->index[0] == 1);
+	}
+
+	void atomic_runtime_checks()
+	{
+		// every thread visits each of the 32 cells updates / 32 times
+		constexpr std::size_t threads{4};
+		constexpr std::size_t updates{3200};
+		[[maybe_unused]] constexpr std::size_t per_cell{updates / 32};
+
+		{// shared counters through an atomic view
+			static std::array<std::array<std::uint64_t, 8>, 4> counts{};
+			static std::array<std::uint64_t, 2> peaks{};
+			const atomic_view view{counts};
+			const atomic_view peak{peaks};
+			using view_t = std::remove_cvref_t<decltype(view)>;
+			static_assert(is_array_v<view_t> && std::is_same_v<extents_of_t<view_t>, extents_of_t<decltype(counts)>>);
+
+			{
+				std::vector<std::jthread> workers{};
+				for (std::size_t t{0}; t < threads; ++t) {
+					workers.emplace_back([&view, &peak, t] {
+						for (std::size_t i{0}; i < updates; ++i) {
+							fetch_add(view, {{i / 8 % 4, i % 8}}, std::uint64_t{1});
+							get<indexer_from_offset_t<31, extents_of_t<view_t>>>(view).fetch_add(1, std::memory_order_relaxed);
+							fetch_max(peak, {{0}}, std::uint64_t{t * updates + i});
+						}
+					});
+				}
+			}
+			assert(counts[0][0] == threads * per_cell);
+			assert(counts[3][7] == threads * per_cell + threads * updates);
+			assert(sum(view) == sum(counts) && sum(view) == 2 * threads * updates);
+			assert(peaks[0] == threads * updates - 1);
+			assert(fetch_min(get(peak, {{0}}), std::uint64_t{5}) == threads * updates - 1 && peaks[0] == 5);
+		}
+
+		{// sharded copies, merged on read
+			using counts_t = std::array<std::array<std::uint64_t, 8>, 4>;
+			static_assert(shard_policy<counts_t>::shard_items == 32);
+			static_assert(sizeof(std::uint64_t) * shard_policy<std::array<std::uint64_t, 9>>::shard_items == 2 * cache_line_bytes);
+
+			sharded_array<counts_t> sharded{threads};
+			{
+				std::vector<std::jthread> workers{};
+				for (std::size_t t{0}; t < threads; ++t) {
+					workers.emplace_back([&sharded, t] {
+						for (std::size_t i{0}; i < updates; ++i) {
+							sharded.update(t, {{i / 8 % 4, i % 8}}, 1);
+						}
+					});
+				}
+			}
+			assert(sharded.shards() == threads);
+			assert(sum(sharded) == threads * updates);
+			assert(get(sharded, {{2, 5}}) == threads * per_cell);
+
+			counts_t counts{};
+			counts[2][2] = 5;
+			sharded.merge_into(counts);
+			assert(counts[2][2] == threads * per_cell + 5);
+
+			sharded_array<std::array<int, 3>, decltype([](int lhs, int rhs) { return std::max(lhs, rhs); })> maxima{2, -1};
+			maxima.update(0, {{1}}, 7);
+			maxima.update(1, {{1}}, 3);
+			maxima.update({{2}}, 4);
+			assert(flatten(maxima) == (std::array{-1, 7, 4}));
+		}
+	}
+
+	constexpr void instrument_checks()
+	{
+		// the hooks cost nothing unless METARRAY_INSTRUMENT is defined
+		static_assert(std::is_empty_v<instrument_scope<decltype(test_array_1), false>>);
+		static_assert(instrumented || std::is_empty_v<instrument_scope<decltype(test_array_1)>>);
+	}
+
+#ifdef METARRAY_INSTRUMENT
+	void instrument_runtime_checks()
+	{
+		static std::vector<algorithm_call> calls{};
+		const auto previous{std::exchange(instrument_sink, [](const algorithm_call& call) { calls.push_back(call); })};
+
+		auto a{test_array_1};
+		[[maybe_unused]] const auto total{sum(a)};
+		assert(calls.size() == 1 && calls[0].algorithm == "sum" && std::ranges::equal(calls[0].extents, std::array{2, 3, 5}));
+		assert(calls[0].items == 30 && calls[0].bytes == 30 * sizeof(int));
+
+		// an indexer gather converts and loads in blocks, but it's still one call
+		calls.clear();
+		std::vector<runtime_indexer_of_t<decltype(a)>> idxs(gather_block * 3 + 1);
+		std::vector<int> out(idxs.size());
+		gather(a, idxs, out);
+		assert(calls.size() == 1 && calls[0].algorithm == "gather" && calls[0].items == idxs.size());
+
+		// k-min selection only touches the items it estimates, in items and in bytes
+		calls.clear();
+		[[maybe_unused]] const auto smallest{k_min_sorted_rows<4>(test_array_3)};
+		assert(calls.size() == 1 && calls[0].algorithm == "k_min_sorted_rows");
+		assert(calls[0].items == 4 + 3 && calls[0].bytes == (4 + 3) * sizeof(int));
+		// a rank 3 array seeds the heap with a head per row, not per outer index: 2 * 3 rows in test_array_1
+		calls.clear();
+		[[maybe_unused]] const auto smallest_3d{k_min_sorted_rows<4>(test_array_1)};
+		assert(calls.size() == 1 && calls[0].items == 4 + 2 * 3 && calls[0].bytes == (4 + 2 * 3) * sizeof(int));
+
+		// the container specific kernels report like the generic overloads they replace
+		const auto padded{make_padded<16>(test_array_3)};
+		const auto packed{make_packed<4>(test_array_1)};
+		cached_array cached{a};
+		calls.clear();
+		// not const - a const integral result of constant arguments would be constant evaluated, and never reported
+		[[maybe_unused]] auto padded_sum{sum(padded)};
+		[[maybe_unused]] auto padded_count{count_if(padded, [](int item) { return item > 20; })};
+		[[maybe_unused]] auto sparse_sum{sum(test_sparse_1)};
+		[[maybe_unused]] auto packed_sum{sum(packed)};
+		[[maybe_unused]] auto packed_count{count(packed, std::uint8_t{3})};
+		[[maybe_unused]] auto cached_sum{sum(cached)};
+		assert(calls.size() == 6 && calls[0].algorithm == "sum" && calls[1].algorithm == "count_if");
+		assert(calls[2].algorithm == "sum" && calls[3].algorithm == "sum" && calls[4].algorithm == "count" && calls[5].algorithm == "sum");
+		assert(calls[0].items == 21 && calls[0].bytes == 21 * sizeof(int) && std::ranges::equal(calls[0].extents, std::array{3, 7}));
+		assert(std::ranges::all_of(calls | std::views::drop(2), [](const algorithm_call& call) { return call.items == 30; }));
+
+		// an exclusive scan runs the inclusive scan's loops, but only reports itself
+		calls.clear();
+		[[maybe_unused]] const auto scanned{exclusive_scan<2>(a)};
+		assert(calls.size() == 1 && calls[0].algorithm == "exclusive_scan" && calls[0].items == 30);
+
+		instrument_sink = previous;
+	}
+#endif
+
+	// flat 3x4 buffer "owned by someone else" - same items as test_array_2, row-major.
+	constexpr int test_buffer_1[12]{10, 20, 30, 40, 11, 21, 31, 41, 12, 22, 32, 42};
+
+	using test_mdspan_1 = stdex::mdspan<const int, stdex::extents<std::size_t, 3, 4>>;
+	struct static_test_mdspan_1 { constexpr static test_mdspan_1 value{test_buffer_1}; };
+
+	constexpr void mdspan_checks()
+	{
+		{// traits
+			static_assert(is_array_v<test_mdspan_1>);
+			static_assert(is_array_v<const test_mdspan_1>);
+			static_assert(not is_array_v<stdex::mdspan<const int, stdex::extents<std::size_t, std::dynamic_extent, 4>>>);
+			static_assert(rank_v<test_mdspan_1> == 2);
+			static_assert(extent_v<test_mdspan_1, 0> == 3);
+			static_assert(extent_v<test_mdspan_1, 1> == 4);
+			static_assert(std::is_same_v<extents_of_t<test_mdspan_1>, std::index_sequence<3, 4>>);
+			static_assert(std::is_same_v<remove_all_extents_t<test_mdspan_1>, int>);
+			static_assert(total_items_v<test_mdspan_1> == 3*4);
+		}
+
+		{// mappings - these hold for the standard <mdspan> and the reference implementation in metamdspan.hpp alike
+			using ext = stdex::extents<std::size_t, 3, 4>;
+			static_assert(stdex::layout_right::mapping<ext>{}(1, 2) == 6 && stdex::layout_right::mapping<ext>{}.stride(0) == 4);
+			static_assert(stdex::layout_left::mapping<ext>{}(1, 2) == 7 && stdex::layout_left::mapping<ext>{}.stride(1) == 3);
+			constexpr stdex::layout_stride::mapping<ext> strided{ext{}, std::array<std::size_t, 2>{1, 6}};
+			static_assert(strided(2, 3) == 20 && strided.required_span_size() == 21 && not strided.is_exhaustive());
+
+			constexpr stdex::extents<std::size_t, std::dynamic_extent, 4> dyn{3};
+			static_assert(dyn.rank() == 2 && dyn.rank_dynamic() == 1 && dyn.extent(0) == 3 && dyn.extent(1) == 4 && dyn == ext{});
+			constexpr stdex::mdspan<const int, decltype(dyn)> m{test_buffer_1, 3};
+			static_assert(m.size() == 12 && m[2, 1] == 22 && m[std::array<std::size_t, 2>{1, 3}] == 41);
+		}
+
+		{// layout_right
+			constexpr test_mdspan_1 m{test_buffer_1};
+			static_assert(get<indexer_of_t<test_mdspan_1>>(m) == 10);
+			static_assert(get<indexer_from_offset_t<5, extents_of_t<test_mdspan_1>>>(m) == 21);
+			static_assert(get<last_indexer_of_t<test_mdspan_1>>(m) == 42);
+			static_assert(sum(m) == sum(test_array_2));
+			static_assert(accumulate(m, 0, std::plus<int>{}) == 312);
+			static_assert(inclusive_scan<1>(m)[2][3] == 12 + 22 + 32 + 42);
+			static_assert(sum<0>(m) == sum<0>(test_array_2) && max<1>(m) == max<1>(test_array_2));
+			static_assert(histogram(m, std::array{0, 20, 40}) == histogram(test_array_2, std::array{0, 20, 40}));
+		}
+
+		{// layout_left - column-major walk of the same buffer
+			using md = stdex::mdspan<const int, stdex::extents<std::size_t, 4, 3>, stdex::layout_left>;
+			constexpr md m{test_buffer_1};
+			static_assert(get<indexer_from_offset_t<1, extents_of_t<md>>>(m) == 11);
+			static_assert(get<indexer_from_offset_t<3, extents_of_t<md>>>(m) == 20);
+			static_assert(sum(m) == 312);
+			static_assert(count_if(m, [](const auto& item) { return item > 30; }) == 5);
+			static_assert(inclusive_scan<0>(m)[3] == std::array{100, 104, 108});
+			static_assert(get(m, argmax(m)) == 42 && argmin(m).index == std::array<std::size_t, 2>{0, 0});
+		}
+
+		{// layout_stride - column 1 of the buffer
+			using md = stdex::mdspan<const int, stdex::extents<std::size_t, 3>, stdex::layout_stride>;
+			constexpr md m{test_buffer_1 + 1, stdex::layout_stride::mapping<md::extents_type>{{}, std::array<std::size_t, 1>{4}}};
+			static_assert(get<last_indexer_of_t<md>>(m) == 22);
+			static_assert(sum(m) == 20 + 21 + 22);
+		}
+
+		{// compile-time algorithms
+			using min_m = decltype(static_find_min<static_test_mdspan_1>());
+			static_assert(std::is_same_v<min_m, indexer_of_t<test_mdspan_1>>);
+			constexpr auto min_m_k4{static_transform_to_array<static_test_mdspan_1>(static_find_k_min<4, static_test_mdspan_1>())};
+			static_assert(min_m_k4 == std::array<int, 4>{10, 11, 12, 20});
+		}
+
+		{// to_mdspan
+			using md_right = decltype(to_mdspan(test_array_1));
+			static_assert(std::is_same_v<extents_of_t<md_right>, extents_of_t<decltype(test_array_1)>>);
+			static_assert(std::is_same_v<md_right::layout_type, stdex::layout_right>);
+			using md_left = decltype(to_mdspan<stdex::layout_left>(test_array_1));
+			static_assert(std::is_same_v<extents_of_t<md_left>, std::index_sequence<5, 3, 2>>);
+			using md_stride = decltype(to_mdspan<stdex::layout_stride>(test_array_2));
+			static_assert(std::is_same_v<extents_of_t<md_stride>, std::index_sequence<3, 4>>);
+
+			constexpr std::array<int, 4> a{1, 2, 3, 4};
+			static_assert(sum(to_mdspan(a)) == 10);
+			static_assert(get<last_indexer_of_t<decltype(a)>>(to_mdspan<stdex::layout_stride>(a)) == 4);
+		}
+	}
+
+	void mdspan_runtime_checks()
+	{
+		int a[2][3]{{1, 2, 3}, {4, 5, 6}};
+		const auto right{to_mdspan(a)};
+		const auto left{to_mdspan<stdex::layout_left>(a)};
+		const auto strided{to_mdspan<stdex::layout_stride>(a)};
+		right[1, 2] = 60;
+		assert((left[2, 1] == 60));
+		assert((strided[1, 2] == 60));
+		assert(sum(right) == sum(left) && sum(left) == sum(strided) && sum(a) == 75);
+	}
 }
 
 int main()
 {
+#ifdef METARRAY_INSTRUMENT
+	metarray::stats_sink::install();
+#endif
 	test::type_checks();
 	test::rank_checks();
 	test::extent_checks();
@@ -733,7 +2308,55 @@ int main()
 	test::offset_checks();
 	test::find_checks();
 	test::find_k_checks();
+	test::find_k_runtime_checks();
+	test::sorted_matrix_checks();
+	test::sorted_matrix_runtime_checks();
+	test::argsort_checks();
+	test::argsort_runtime_checks();
+	test::generate_checks();
+	test::gather_checks();
+	test::gather_runtime_checks();
+	test::tiling_checks();
+	test::tiling_runtime_checks();
+	test::stencil_checks();
+	test::stencil_runtime_checks();
 	test::algo_checks();
+	test::reduce_many_checks();
+	test::reduce_many_runtime_checks();
+	test::counting_checks();
+	test::counting_runtime_checks();
+	test::scan_checks();
+	test::scan_runtime_checks();
+	test::axis_reduction_checks();
+	test::axis_reduction_runtime_checks();
+	test::runtime_indexer_checks();
+	test::runtime_indexer_runtime_checks();
+	test::extrema_checks();
+	test::extrema_runtime_checks();
+	test::sparse_checks();
+	test::index_checks();
+	test::padded_checks();
+	test::padded_runtime_checks();
+	test::packed_checks();
+	test::packed_runtime_checks();
+	test::atomic_runtime_checks();
+	test::soa_checks();
+	test::cached_checks();
+	test::cached_runtime_checks();
+	test::morton_checks();
+	test::morton_runtime_checks();
+	test::iterator_checks();
+	test::iterator_runtime_checks();
+	test::instrument_checks();
+#ifdef METARRAY_INSTRUMENT
+	test::instrument_runtime_checks();
+#endif
+	test::mdspan_checks();
+	test::mdspan_runtime_checks();
+
+#ifdef METARRAY_INSTRUMENT
+	metarray::stats_sink::instance().dump(std::cout);
+#endif
 
 	std::cout << "###\n";
 